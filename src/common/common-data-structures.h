@@ -816,6 +816,11 @@ typedef enum
 	kCommonRlimitCpuSeconds				= 5*60,			/*	5 mins	*/
 	kCommonRlimitRssBytes				= 2*1024*1024*1024UL,	/*	2GB	*/
 	kCommonProgressTimerSeconds			= 5,
+	kCommonArenaBlockBytes				= 1024*1024,
+	kCommonArenaAlignment				= 16,
+	kCommonInternTableInitialBuckets		= 1024,
+	kCommonScopeSymbolTableInitialBuckets		= 8,
+	kCommonTokenBufferInitialSize			= 1024,
 
 	/*
 	 *	Code depends on this bringing up the rear.
@@ -1100,6 +1105,9 @@ struct SourceInfo
 	 */
 	char **			genealogy;
 	
+	/*
+	 *	Interned, so it is shared by all the tokens from one file.
+	 */
 	char *			fileName;
 	uint64_t		lineNumber;
 	uint64_t		columnNumber;
@@ -1115,9 +1123,6 @@ struct Token
 	double			realConst;
 	char *			stringConst;
 	SourceInfo *		sourceInfo;
-	
-	Token *			prev;
-	Token *			next;
 };
 
 
@@ -1142,6 +1147,16 @@ struct Scope
 	 */
 	Symbol *		firstSymbol;
 
+	/*
+	 *	Tail of that list, for O(1) appends, and an open-addressing hash
+	 *	table from interned identifier to the first symbol of that name
+	 *	in this scope (allocated on the first insert).
+	 */
+	Symbol *		lastSymbol;
+	Symbol **		symbolBuckets;
+	int			symbolBucketCount;
+	int			symbolBucketUsed;
+
 	/*
 	 *	Each invariant scope will have its own list of parameters
 	 */
@@ -1258,6 +1273,38 @@ struct Symbol
 };
 
 
+/*
+ *	The source file being lexed, mapped (or, if it can't be mapped, read)
+ *	whole. N->lineBuffer points at the current line within it.
+ */
+typedef struct SourceBuffer	SourceBuffer;
+struct SourceBuffer
+{
+	char *			buffer;
+	uint64_t		size;
+	uint64_t		offset;		/*	Start of the next line	*/
+	bool			isMapped;
+};
+
+
+/*
+ *	A block of the region the front-end nodes are allocated from.
+ *	The blocks are chained from the most recent one.
+ */
+typedef struct ArenaBlock	ArenaBlock;
+struct ArenaBlock
+{
+	ArenaBlock *		next;
+	size_t			size;
+	size_t			used;
+
+	/*
+	 *	The long double keeps the data aligned for any of the node types
+	 */
+	long double		data[];
+};
+
+
 typedef struct
 {
 	/*
@@ -1339,10 +1386,25 @@ typedef struct
 	 */
 	Scope *		moduleScopes;
 
+	/*
+	 *	Region (arena) the tokens, source info, IR nodes, symbols and scopes,
+	 *	and their strings, are allocated from. Nothing in it is freed on its
+	 *	own: dealloc() releases it all at the end of the compilation unit.
+	 */
+	ArenaBlock *		arena;
+
+	/*
+	 *	Open-addressing table of interned identifiers (in the arena). All
+	 *	symbol identifiers are interned, so symbol lookups compare pointers.
+	 */
+	const char **		internTable;
+	int			internTableBucketCount;
+	int			internTableUsed;
+
 	/*
 	 *	Lexer state
 	 */
-	FILE *			filePointer;
+	SourceBuffer		source;
 	char *			fileName;
 	char *			lineBuffer;
 	uint64_t		columnNumber;
@@ -1350,8 +1412,17 @@ typedef struct
 	uint64_t		lineLength;
 	char *			currentToken;
 	uint64_t		currentTokenLength;
-	Token *			tokenList;
-	Token *			lastToken;
+
+	/*
+	 *	Tokens in lexing order (the Token objects themselves are in the
+	 *	arena). The parser consumes them by advancing tokenIndex, so
+	 *	lookahead is an index rather than a walk down a list.
+	 */
+	Token **		tokenBuffer;
+	int			tokenBufferSize;
+	int			tokenCount;
+	int			tokenIndex;
+
 	Symbol *		currentFunction;
 
 	/*
@@ -1384,6 +1455,30 @@ typedef struct
 	 *	LLVM IR input file
 	 */
 	char *			llvmIR;
+
+	/*
+	 *	Functions whose comparisons the LLVM IR range analysis also decides
+	 *	with the difference bounds between values, comma separated or "all"
+	 */
+	char *			llvmIRRelationalFunctions;
+
+	/*
+	 *	Largest absolute error of the floating-point outputs of the LLVM IR,
+	 *	0 keeps the precision of every value
+	 */
+	double			llvmIRErrorBudget;
+
+	/*
+	 *	Shrink the types of the LLVM IR for the loop vectorizer: narrow the arrays
+	 *	and weigh the loops by the lanes of the vector registers of the target
+	 */
+	bool			llvmIRVectorizeShrink;
+
+	/*
+	 *	Largest growth of the LLVM IR by the functions specialized by the
+	 *	ranges of their arguments, in percent of its instructions, 0 for the default
+	 */
+	uint64_t		llvmIRSpecializationBudget;
 	
 	/*
 	 *	Variables for storing lists of identifiers attached
@@ -1428,6 +1523,10 @@ void		timeStampDumpTimeline(State *  C);
 void		timeStampDumpResidencies(State *  C);
 State *		init(CommonMode mode);
 void		dealloc(State *  C);
+void *		arenaAllocate(State *  C, size_t size);
+char *		arenaStrdup(State *  C, const char *  string);
+char *		arenaStrndup(State *  C, const char *  string, size_t length);
+void		arenaRelease(State *  C);
 void		runPasses(State *  C);
 uint64_t	checkRss(State *  C);
 void		consolePrintBuffers(State *  C);
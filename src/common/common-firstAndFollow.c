@@ -51,32 +51,99 @@
 #include "common-firstAndFollow.h"
 
 /*
- *	NOTE: Unlike in our previous compilers (e.g., Crayon), we do
- *
- *		inFirst(IrNodeType productionOrToken)
- *
- *	with the token being checked implicit in the lexer state, rather than
- *
- *		inFirst(IrNodeType productionOrToken, IrNodeType token)
+ *	The FIRST() and FOLLOW() arrays created by ffi2code are lists of
+ *	IrNodeTypes, terminated by maxKey and padded out to the full row.
+ *	Scanning a row on every parser decision is a hot spot, so the first
+ *	time we see an array we pack each row into a bitset over the
+ *	IrNodeTypes. After that, membership is a single word test. The
+ *	arrays are static, so the bitsets live for the rest of the run.
  */
-bool
-inFirst(State *  N, IrNodeType productionOrToken, int firsts[kCommonIrNodeTypeMax][kCommonIrNodeTypeMax], int maxKey)
+typedef struct
 {
-	TimeStampTraceMacro(kNoisyTimeStampKeyInFirst);
+	int		(*array)[kCommonIrNodeTypeMax];
+	int		maxKey;
+	uint64_t	(*bits)[kCommonFirstAndFollowSetWords];
+} FirstAndFollowSet;
 
+static FirstAndFollowSet	gFirstAndFollowSets[kCommonFirstAndFollowMaxCachedSets];
+
+
+static uint64_t *
+firstAndFollowBitsForRow(State *  N, int array[kCommonIrNodeTypeMax][kCommonIrNodeTypeMax], int maxKey, IrNodeType productionOrToken)
+{
+	int	i;
+
+	for (i = 0; i < kCommonFirstAndFollowMaxCachedSets && gFirstAndFollowSets[i].array != NULL; i++)
+	{
+		if (gFirstAndFollowSets[i].array == array && gFirstAndFollowSets[i].maxKey == maxKey)
+		{
+			return gFirstAndFollowSets[i].bits[productionOrToken];
+		}
+	}
+
+	/*
+	 *	More distinct arrays than we expect: the caller falls back to scanning.
+	 */
+	if (i == kCommonFirstAndFollowMaxCachedSets)
+	{
+		return NULL;
+	}
+
+	uint64_t	(*bits)[kCommonFirstAndFollowSetWords] = calloc(kCommonIrNodeTypeMax, sizeof(*bits));
+	if (bits == NULL)
+	{
+		fatal(N, Emalloc);
+	}
+
+	/*
+	 *	Same termination as the original scan, so the answers are identical.
+	 */
+	for (int row = 0; row < kCommonIrNodeTypeMax; row++)
+	{
+		for (int j = 0; j < maxKey && array[row][j] != maxKey; j++)
+		{
+			if (array[row][j] >= 0 && array[row][j] < kCommonIrNodeTypeMax)
+			{
+				bits[row][array[row][j] / 64] |= (uint64_t)1 << (array[row][j] % 64);
+			}
+		}
+	}
+
+	gFirstAndFollowSets[i].array	= array;
+	gFirstAndFollowSets[i].maxKey	= maxKey;
+	gFirstAndFollowSets[i].bits	= bits;
+
+	return bits[productionOrToken];
+}
+
+
+static bool
+inFirstOrFollow(State *  N, IrNodeType productionOrToken, int array[kCommonIrNodeTypeMax][kCommonIrNodeTypeMax], int maxKey)
+{
 	Token *	token = lexPeek(N, 1);
 
-	if (productionOrToken > kCommonIrNodeTypeMax)
+	if (productionOrToken >= kCommonIrNodeTypeMax)
 	{
 		fatal(N, Esanity);
 	}
 
+	if (token->type < 0 || token->type >= kCommonIrNodeTypeMax)
+	{
+		return false;
+	}
+
+	uint64_t *	bits = firstAndFollowBitsForRow(N, array, maxKey, productionOrToken);
+	if (bits != NULL)
+	{
+		return (bits[token->type / 64] >> (token->type % 64)) & 1;
+	}
+
 	/*
 	 *	NOTE: The arrays created by ffi2code have a maxKey element at the end of each sub-array
 	 */
-	for (int i = 0; i < maxKey && firsts[productionOrToken][i] != maxKey; i++)
+	for (int i = 0; i < maxKey && array[productionOrToken][i] != maxKey; i++)
 	{
-		if (firsts[productionOrToken][i] == token->type)
+		if (array[productionOrToken][i] == token->type)
 		{
 			return true;
 		}
@@ -86,6 +153,24 @@ inFirst(State *  N, IrNodeType productionOrToken, int firsts[kCommonIrNodeTypeMa
 }
 
 
+/*
+ *	NOTE: Unlike in our previous compilers (e.g., Crayon), we do
+ *
+ *		inFirst(IrNodeType productionOrToken)
+ *
+ *	with the token being checked implicit in the lexer state, rather than
+ *
+ *		inFirst(IrNodeType productionOrToken, IrNodeType token)
+ */
+bool
+inFirst(State *  N, IrNodeType productionOrToken, int firsts[kCommonIrNodeTypeMax][kCommonIrNodeTypeMax], int maxKey)
+{
+	TimeStampTraceMacro(kNoisyTimeStampKeyInFirst);
+
+	return inFirstOrFollow(N, productionOrToken, firsts, maxKey);
+}
+
+
 /*
  *	NOTE: Unlike in our previous compilers (e.g., Crayon), we do
  *
@@ -100,23 +185,5 @@ inFollow(State *  N, IrNodeType productionOrToken, int follows[kCommonIrNodeType
 {
 	TimeStampTraceMacro(kNoisyTimeStampKeyInFollow);
 
-	Token *	token = lexPeek(N, 1);
-
-	if (productionOrToken > kCommonIrNodeTypeMax)
-	{
-		fatal(N, Esanity);
-	}
-
-	/*
-	 *	NOTE: The arrays created by ffi2code have a maxKey element at the end of each sub-array
-	 */
-	for (int i = 0; i < maxKey && follows[productionOrToken][i] != maxKey; i++)
-	{
-		if (follows[productionOrToken][i] == token->type)
-		{
-			return true;
-		}
-	}
-
-	return false;
+	return inFirstOrFollow(N, productionOrToken, follows, maxKey);
 }
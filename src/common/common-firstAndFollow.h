@@ -34,5 +34,11 @@
 	ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
 	POSSIBILITY OF SUCH DAMAGE.
 */
+enum
+{
+	kCommonFirstAndFollowSetWords		= (kCommonIrNodeTypeMax + 63) / 64,
+	kCommonFirstAndFollowMaxCachedSets	= 8,
+};
+
 bool inFirst(State *  N, IrNodeType productionOrToken, int firsts[kCommonIrNodeTypeMax][kCommonIrNodeTypeMax], int maxKey);
 bool inFollow(State *  N, IrNodeType productionOrToken, int follows[kCommonIrNodeTypeMax][kCommonIrNodeTypeMax], int maxKey);
@@ -65,11 +65,7 @@
 IrNode *
 shallowCopyIrNode(State *  N, IrNode *  original)
 {
-	IrNode *	clone = calloc(1, sizeof(IrNode));
-	if (clone == NULL)
-	{
-		fatal(N, Emalloc);
-	}
+	IrNode *	clone = arenaAllocate(N, sizeof(IrNode));
 
 	memcpy(clone, original, sizeof(IrNode));
 	// clone->irLeftChild = NULL;
@@ -91,41 +87,30 @@ shallowCopyIrNode(State *  N, IrNode *  original)
 IrNode *
 deepCopyIrNode(State * N,IrNode * original,int loadCount)
 {
-	IrNode *	clone = calloc(1, sizeof(IrNode));
-	if (clone == NULL)
-	{
-		fatal(N, Emalloc);
-	}
+	IrNode *	clone = arenaAllocate(N, sizeof(IrNode));
 	memcpy(clone,original,sizeof(IrNode));
 
 
 	if (original->symbol != NULL)
 	{
-		Symbol * symbolClone = calloc(1,sizeof(Symbol));
-
-		if (symbolClone == NULL)
-		{
-			fatal(N, Emalloc);
-		}
-
-		memcpy(symbolClone,original->symbol,sizeof(Symbol));
 		char * newSymbolName;
-		asprintf(&newSymbolName,"%s_%d",symbolClone->identifier,loadCount);
-		symbolClone->identifier = strdup(newSymbolName);
+		asprintf(&newSymbolName,"%s_%d",original->symbol->identifier,loadCount);
 
-		clone->symbol = commonSymbolTableSymbolForIdentifier(N,symbolClone->scope,newSymbolName);
+		clone->symbol = commonSymbolTableSymbolForIdentifier(N,original->symbol->scope,newSymbolName);
 
-		if (clone->symbol != NULL)
+		/*
+		 *	The symbol is only cloned (into the arena) if the scope doesn't have it yet.
+		 */
+		if (clone->symbol == NULL)
 		{
-			free(symbolClone);
-		}
-		else
-		{
-			symbolClone->next = original->symbol->scope->firstSymbol;
-			original->symbol->scope->firstSymbol = symbolClone;
-			symbolClone->prev = NULL;
+			Symbol * symbolClone = arenaAllocate(N, sizeof(Symbol));
+
+			memcpy(symbolClone,original->symbol,sizeof(Symbol));
+			symbolClone->identifier = newSymbolName;
+			commonSymbolTableInsertSymbol(N, original->symbol->scope, symbolClone);
 			clone->symbol = symbolClone;
 		}
+		free(newSymbolName);
 	}
 
 
@@ -149,13 +134,7 @@ genIrNode(State *  N, IrNodeType type, IrNode *  irLeftChild, IrNode *  irRightC
 
 	IrNode *		node;
 
-	node = (IrNode *) calloc(1, sizeof(IrNode));
-	if (node == NULL)
-	{
-		fatal(N, Emalloc);
-
-		/*	Not reached	*/
-	}
+	node = (IrNode *) arenaAllocate(N, sizeof(IrNode));
 
 	node->type		= type;
 	node->sourceInfo	= sourceInfo;
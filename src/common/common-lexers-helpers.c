@@ -43,6 +43,11 @@
 #include <string.h>
 #include <stdint.h>
 #include <inttypes.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include "flextypes.h"
 #include "flexerror.h"
 #include "flex.h"
@@ -56,6 +61,7 @@
 #include "common-timeStamps.h"
 #include "common-data-structures.h"
 #include "common-lexers-helpers.h"
+#include "common-symbolTable.h"
 
 void
 checkTokenLength(State *  N, int  count)
@@ -73,9 +79,32 @@ cur(State *  N)
 {
 	TimeStampTraceMacro(kCommonTimeStampKeyLexerCur);
 
+	/*
+	 *	Lines are views into the source, not NUL-terminated copies
+	 */
+	if (N->columnNumber >= N->lineLength)
+	{
+		return '\0';
+	}
+
 	return N->lineBuffer[N->columnNumber];
 }
 
+/*
+ *	The character count places past the current one, or '\0' past the
+ *	end of the line (as a NUL-terminated line buffer would give).
+ */
+char
+lexLookAhead(State *  N, int count)
+{
+	if (N->columnNumber + count >= N->lineLength)
+	{
+		return '\0';
+	}
+
+	return N->lineBuffer[N->columnNumber + count];
+}
+
 void
 gobble(State *  N, int count)
 {
@@ -114,7 +143,7 @@ eqf(State *  N)
 {
 	TimeStampTraceMacro(kCommonTimeStampKeyLexerEqf);
 
-	return (N->lineLength >= 2 && N->lineBuffer[N->columnNumber+1] == '=');
+	return (N->lineLength >= 2 && lexLookAhead(N, 1) == '=');
 }
 
 
@@ -494,14 +523,10 @@ lexAllocateSourceInfo(	State *  N, char **  genealogy, char *  fileName,
 
 	SourceInfo *	newSourceInfo;
 
-	newSourceInfo = (SourceInfo *) calloc(1, sizeof(SourceInfo));
-	if (newSourceInfo == NULL)
-	{
-		fatal(N, Emalloc);
-	}
+	newSourceInfo = (SourceInfo *) arenaAllocate(N, sizeof(SourceInfo));
 
 	newSourceInfo->genealogy	= genealogy;
-	newSourceInfo->fileName		= (fileName == NULL ? NULL : strdup(fileName));
+	newSourceInfo->fileName		= (char *)commonSymbolTableInternIdentifier(N, fileName);
 	newSourceInfo->lineNumber	= lineNumber;
 	newSourceInfo->columnNumber	= columnNumber;
 	newSourceInfo->length		= length;
@@ -519,17 +544,13 @@ lexAllocateToken(	State *  N, IrNodeType type, char *  identifier,
 
 	Token *	newToken;
 
-	newToken = (Token *) calloc(1, sizeof(Token));
-	if (newToken == NULL)
-	{
-		fatal(N, Emalloc);
-	}
+	newToken = (Token *) arenaAllocate(N, sizeof(Token));
 
 	newToken->type		= type;
-	newToken->identifier	= (identifier == NULL ? NULL : strdup(identifier));
+	newToken->identifier	= (char *)commonSymbolTableInternIdentifier(N, identifier);
 	newToken->integerConst	= integerConst;
 	newToken->realConst	= realConst;
-	newToken->stringConst	= (stringConst == NULL ? NULL : strdup(stringConst));
+	newToken->stringConst	= (stringConst == NULL ? NULL : arenaStrdup(N, stringConst));
 	newToken->sourceInfo	= sourceInfo;
 
 	return newToken;
@@ -537,6 +558,129 @@ lexAllocateToken(	State *  N, IrNodeType type, char *  identifier,
 
 
 
+/*
+ *	Map fileName whole, instead of copying it in line by line. Inputs
+ *	that can't be mapped (e.g., pipes) are read into a buffer instead.
+ */
+void
+lexMapSource(State *  N, char *  fileName)
+{
+	TimeStampTraceMacro(kCommonTimeStampKeyLexMapSource);
+
+	int		fd;
+	struct stat	sb;
+
+	fd = open(fileName, O_RDONLY);
+	if ((fd < 0) || (fstat(fd, &sb) < 0))
+	{
+		flexprint(N->Fe, N->Fm, N->Fperr, "Could not open file \"%s\".\n", fileName);
+		fatal(N, Eopen);
+	}
+
+	N->source.buffer	= NULL;
+	N->source.size		= 0;
+	N->source.offset	= 0;
+	N->source.isMapped	= false;
+
+	if (S_ISREG(sb.st_mode))
+	{
+		if (sb.st_size == 0)
+		{
+			close(fd);
+
+			return;
+		}
+
+		void *	mapping = mmap(NULL, sb.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (mapping != MAP_FAILED)
+		{
+			madvise(mapping, sb.st_size, MADV_SEQUENTIAL);
+
+			N->source.buffer	= mapping;
+			N->source.size		= sb.st_size;
+			N->source.isMapped	= true;
+			close(fd);
+
+			return;
+		}
+	}
+
+	uint64_t	capacity = 0;
+	ssize_t		count;
+	do
+	{
+		if (N->source.size == capacity)
+		{
+			capacity = (capacity == 0 ? kCommonMaxBufferLength : capacity * 2);
+			N->source.buffer = realloc(N->source.buffer, capacity);
+			if (N->source.buffer == NULL)
+			{
+				fatal(N, Emalloc);
+			}
+		}
+
+		count = read(fd, N->source.buffer + N->source.size, capacity - N->source.size);
+		if (count > 0)
+		{
+			N->source.size += count;
+		}
+		else if (count < 0 && errno != EINTR)
+		{
+			close(fd);
+			flexprint(N->Fe, N->Fm, N->Fperr, "Could not open file \"%s\".\n", fileName);
+			fatal(N, Eopen);
+		}
+	} while (count != 0);
+
+	close(fd);
+}
+
+
+/*
+ *	Point N->lineBuffer at the next line of the source, including its
+ *	'\n' (if any). Returns false at the end of the source.
+ */
+bool
+lexNextLine(State *  N)
+{
+	if (N->source.offset >= N->source.size)
+	{
+		return false;
+	}
+
+	char *		line = N->source.buffer + N->source.offset;
+	uint64_t	remaining = N->source.size - N->source.offset;
+	char *		newline = memchr(line, '\n', remaining);
+
+	N->lineBuffer		= line;
+	N->lineLength		= (newline == NULL ? remaining : (uint64_t)(newline - line) + 1);
+	N->source.offset	+= N->lineLength;
+
+	return true;
+}
+
+
+void
+lexUnmapSource(State *  N)
+{
+	if (N->source.isMapped)
+	{
+		munmap(N->source.buffer, N->source.size);
+	}
+	else
+	{
+		free(N->source.buffer);
+	}
+
+	N->source.buffer	= NULL;
+	N->source.size		= 0;
+	N->source.offset	= 0;
+	N->source.isMapped	= false;
+	N->lineBuffer		= NULL;
+	N->lineLength		= 0;
+}
+
+
 void
 lexPut(State *  N, Token *  newToken)
 {
@@ -548,18 +692,22 @@ lexPut(State *  N, Token *  newToken)
 	}
 
 	/*
-	 *	If the token list is empty, we allocate and put on an EOF node, which we never remove.
-	 */	
-	if (N->tokenList == NULL)
-	{
-		N->lastToken = N->tokenList = newToken;
-	}
-	else
+	 *	Grow the buffer by doubling. The old buffer is left in the arena.
+	 */
+	if (N->tokenCount == N->tokenBufferSize)
 	{
-		newToken->prev = N->lastToken;
-		N->lastToken->next = newToken;
-		N->lastToken = newToken;
+		int		newSize = (N->tokenBufferSize == 0 ? kCommonTokenBufferInitialSize : N->tokenBufferSize * 2);
+		Token **	newBuffer = (Token **)arenaAllocate(N, newSize * sizeof(Token *));
+
+		if (N->tokenCount > 0)
+		{
+			memcpy(newBuffer, N->tokenBuffer, N->tokenCount * sizeof(Token *));
+		}
+		N->tokenBuffer		= newBuffer;
+		N->tokenBufferSize	= newSize;
 	}
+
+	N->tokenBuffer[N->tokenCount++] = newToken;
 }
 
 
@@ -568,16 +716,19 @@ lexGet(State *  N, const char *  tokenDescriptionArray[kCommonIrNodeTypeMax])
 {
 	TimeStampTraceMacro(kCommonTimeStampKeyLexGet);
 
-	if (N->tokenList == NULL)
+	if (N->tokenIndex >= N->tokenCount)
 	{
 		fatal(N, Esanity);
 	}
 
-	Token *	t = N->tokenList;
-	
-	if (t->next != NULL)
+	Token *	t = N->tokenBuffer[N->tokenIndex];
+
+	/*
+	 *	The final (EOF) token is never consumed by lexGet().
+	 */
+	if (N->tokenIndex + 1 < N->tokenCount)
 	{
-		N->tokenList = N->tokenList->next;
+		N->tokenIndex++;
 	}
 	else if ((t->type != kNewtonIrNodeType_Zeof) && (t->type != kNoisyIrNodeType_Zeof))
 	{
@@ -598,28 +749,16 @@ lexPeek(State *  N, int lookAhead)
 {
 	TimeStampTraceMacro(kCommonTimeStampKeyLexPeek);
 
-	if (N->tokenList == NULL)
-	{
-		fatal(N, Esanity);
-	}
-
-	Token *	tmp = N->tokenList;
-	int 		which = 1;
-	while ((tmp != NULL) && (which++ < lookAhead))
-	{
-		tmp = tmp->next;
-	}
-
 	/*
 	 *	We don't intend for callers to check if the result of lexPeek is NULL
 	 *	as it should only be used when lexPeek should never result in NULL 
 	 */
-	if (tmp == NULL)
+	if ((lookAhead < 1) || (N->tokenIndex + lookAhead > N->tokenCount))
 	{
 		fatal(N, Esanity);
 	}
 
-	return tmp;
+	return N->tokenBuffer[N->tokenIndex + lookAhead - 1];
 }
 
 
@@ -741,13 +880,14 @@ lexPeekPrint(State *  N, int maxTokens, int formatCharacters, const char *  toke
 {
 	TimeStampTraceMacro(kCommonTimeStampKeyLexPeekPrint);
 
-	if (N->tokenList == NULL)
+	if (N->tokenIndex >= N->tokenCount)
 	{
 		fatal(N, Esanity);
 	}
 
 	int		tripCharacters = 0, done = 0;
-	Token *	tmp = N->tokenList;
+	int		index = N->tokenIndex;
+	Token *	tmp = N->tokenBuffer[index];
 
 	if (N->mode & kCommonModeCGI)
 	{
@@ -760,6 +900,8 @@ lexPeekPrint(State *  N, int maxTokens, int formatCharacters, const char *  toke
 
 	while (tmp != NULL)
 	{
+		Token *	next = (index + 1 < N->tokenCount ? N->tokenBuffer[index + 1] : NULL);
+
 		if (maxTokens > 0 && (done++ > maxTokens))
 		{
 			flexprint(N->Fe, N->Fm, N->Fperr, "...");
@@ -844,18 +986,18 @@ lexPeekPrint(State *  N, int maxTokens, int formatCharacters, const char *  toke
 				}
 			}
 
-			if ((tmp->next != NULL) && (tmp->sourceInfo->lineNumber != tmp->next->sourceInfo->lineNumber))
+			if ((next != NULL) && (tmp->sourceInfo->lineNumber != next->sourceInfo->lineNumber))
 			{
 				//flexprint(N->Fe, N->Fm, N->Fperr, "(newlines)");
 				tripCharacters = 0;
 
 				if (N->mode & kCommonModeCGI)
 				{
-					flexprint(N->Fe, N->Fm, N->Fperr, "\n\tline %5d\t\t", tmp->next->sourceInfo->lineNumber);
+					flexprint(N->Fe, N->Fm, N->Fperr, "\n\tline %5d\t\t", next->sourceInfo->lineNumber);
 				}
 				else
 				{
-					flexprint(N->Fe, N->Fm, N->Fperr, "\n\tsource file: %40s, line %5d\t\t", tmp->sourceInfo->fileName, tmp->next->sourceInfo->lineNumber);
+					flexprint(N->Fe, N->Fm, N->Fperr, "\n\tsource file: %40s, line %5d\t\t", tmp->sourceInfo->fileName, next->sourceInfo->lineNumber);
 				}
 			}
 			else if (tripCharacters >= formatCharacters)
@@ -872,7 +1014,8 @@ lexPeekPrint(State *  N, int maxTokens, int formatCharacters, const char *  toke
 			}
 		}
 
-		tmp = tmp->next;
+		tmp = next;
+		index++;
 	}
 	flexprint(N->Fe, N->Fm, N->Fperr, "\n");
 }
@@ -61,6 +61,10 @@ Token *		lexAllocateToken(	State *  N, IrNodeType type,
 							char *  identifier, int64_t integerConst,
 							double realConst, char * stringConst,
 							SourceInfo *  sourceInfo);
+void		lexMapSource(State *  N, char *  fileName);
+bool		lexNextLine(State *  N);
+void		lexUnmapSource(State *  N);
+char		lexLookAhead(State *  N, int count);
 void		lexPut(State *  N, Token *  newToken);
 Token *		lexGet(State *  N, const char *  tokenDescriptionArray[kCommonIrNodeTypeMax]);
 Token *		lexPeek(State *  N, int lookAhead);
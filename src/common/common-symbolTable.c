@@ -56,6 +56,187 @@
  *	See issue #295.
  */
 
+
+/*
+ *	FNV-1a over the characters, for the intern table.
+ */
+static uint32_t
+commonSymbolTableHashString(const char *  string)
+{
+	uint32_t	hash = 2166136261u;
+
+	for (const unsigned char * p = (const unsigned char *)string; *p != '\0'; p++)
+	{
+		hash = (hash ^ *p) * 16777619u;
+	}
+
+	return hash;
+}
+
+/*
+ *	Interned identifiers are unique, so the scope tables hash the pointer.
+ */
+static uint32_t
+commonSymbolTableHashPointer(const char *  interned)
+{
+	return (uint32_t)(((uintptr_t)interned >> 3) * 2654435761u);
+}
+
+
+static const char *
+commonSymbolTableIntern(State *  N, const char *  identifier, bool insert)
+{
+	if (identifier == NULL)
+	{
+		return NULL;
+	}
+
+	/*
+	 *	Keep the load factor at or below one half. The old table is
+	 *	left in the arena.
+	 */
+	if (insert && (N->internTableUsed + 1) * 2 > N->internTableBucketCount)
+	{
+		int		oldCount = N->internTableBucketCount;
+		const char **	oldTable = N->internTable;
+		int		newCount = (oldCount == 0 ? kCommonInternTableInitialBuckets : oldCount * 2);
+
+		N->internTable = (const char **)arenaAllocate(N, newCount * sizeof(const char *));
+		N->internTableBucketCount = newCount;
+
+		for (int i = 0; i < oldCount; i++)
+		{
+			if (oldTable[i] == NULL)
+			{
+				continue;
+			}
+
+			uint32_t	j = commonSymbolTableHashString(oldTable[i]) & (newCount - 1);
+			while (N->internTable[j] != NULL)
+			{
+				j = (j + 1) & (newCount - 1);
+			}
+			N->internTable[j] = oldTable[i];
+		}
+	}
+
+	if (N->internTableBucketCount == 0)
+	{
+		return NULL;
+	}
+
+	uint32_t	mask = N->internTableBucketCount - 1;
+	uint32_t	i = commonSymbolTableHashString(identifier) & mask;
+	while (N->internTable[i] != NULL)
+	{
+		if (N->internTable[i] == identifier || !strcmp(N->internTable[i], identifier))
+		{
+			return N->internTable[i];
+		}
+		i = (i + 1) & mask;
+	}
+
+	if (!insert)
+	{
+		return NULL;
+	}
+
+	N->internTable[i] = arenaStrdup(N, identifier);
+	N->internTableUsed++;
+
+	return N->internTable[i];
+}
+
+/*
+ *	Returns the canonical copy of identifier, adding it if it is new.
+ */
+const char *
+commonSymbolTableInternIdentifier(State *  N, const char *  identifier)
+{
+	return commonSymbolTableIntern(N, identifier, true);
+}
+
+/*
+ *	Returns the canonical copy of identifier, or NULL if it was never
+ *	interned (in which case no symbol can have that name).
+ */
+const char *
+commonSymbolTableLookupInternedIdentifier(State *  N, const char *  identifier)
+{
+	return commonSymbolTableIntern(N, identifier, false);
+}
+
+
+static Symbol *
+commonSymbolTableScopeLookup(Scope *  scope, const char *  interned)
+{
+	if (scope->symbolBucketCount == 0)
+	{
+		return NULL;
+	}
+
+	uint32_t	mask = scope->symbolBucketCount - 1;
+	uint32_t	i = commonSymbolTableHashPointer(interned) & mask;
+	while (scope->symbolBuckets[i] != NULL)
+	{
+		if (scope->symbolBuckets[i]->identifier == interned)
+		{
+			return scope->symbolBuckets[i];
+		}
+		i = (i + 1) & mask;
+	}
+
+	return NULL;
+}
+
+static void
+commonSymbolTableScopeTableInsert(State *  N, Scope *  scope, Symbol *  symbol)
+{
+	if ((scope->symbolBucketUsed + 1) * 2 > scope->symbolBucketCount)
+	{
+		int		oldCount = scope->symbolBucketCount;
+		Symbol **	oldBuckets = scope->symbolBuckets;
+		int		newCount = (oldCount == 0 ? kCommonScopeSymbolTableInitialBuckets : oldCount * 2);
+
+		scope->symbolBuckets = (Symbol **)arenaAllocate(N, newCount * sizeof(Symbol *));
+		scope->symbolBucketCount = newCount;
+
+		for (int i = 0; i < oldCount; i++)
+		{
+			if (oldBuckets[i] == NULL)
+			{
+				continue;
+			}
+
+			uint32_t	j = commonSymbolTableHashPointer(oldBuckets[i]->identifier) & (newCount - 1);
+			while (scope->symbolBuckets[j] != NULL)
+			{
+				j = (j + 1) & (newCount - 1);
+			}
+			scope->symbolBuckets[j] = oldBuckets[i];
+		}
+	}
+
+	/*
+	 *	The first symbol of a given name in a scope is the one lookups
+	 *	find, as with the linear walk this replaces.
+	 */
+	uint32_t	mask = scope->symbolBucketCount - 1;
+	uint32_t	i = commonSymbolTableHashPointer(symbol->identifier) & mask;
+	while (scope->symbolBuckets[i] != NULL)
+	{
+		if (scope->symbolBuckets[i]->identifier == symbol->identifier)
+		{
+			return;
+		}
+		i = (i + 1) & mask;
+	}
+
+	scope->symbolBuckets[i] = symbol;
+	scope->symbolBucketUsed++;
+}
+
+
 Scope *
 commonSymbolTableAllocScope(State *  N)
 {
@@ -63,13 +244,33 @@ commonSymbolTableAllocScope(State *  N)
 
 	Scope *	newScope;
 
-	newScope = (Scope *)calloc(1, sizeof(Scope));
-	if (newScope == NULL)
+	newScope = (Scope *)arenaAllocate(N, sizeof(Scope));
+
+	return newScope;
+}
+
+/*
+ *	Interns the symbol's identifier, appends the symbol to the scope's
+ *	list and enters it in the scope's hash table.
+ */
+void
+commonSymbolTableInsertSymbol(State *  N, Scope *  scope, Symbol *  symbol)
+{
+	symbol->identifier	= (char *)commonSymbolTableInternIdentifier(N, symbol->identifier);
+	symbol->next		= NULL;
+	symbol->prev		= scope->lastSymbol;
+
+	if (scope->firstSymbol == NULL)
 	{
-		fatal(N, Emalloc);
+		scope->firstSymbol = symbol;
 	}
+	else
+	{
+		scope->lastSymbol->next = symbol;
+	}
+	scope->lastSymbol = symbol;
 
-	return newScope;
+	commonSymbolTableScopeTableInsert(N, scope, symbol);
 }
 
 Symbol *
@@ -79,11 +280,7 @@ commonSymbolTableAddOrLookupSymbolForToken(State *  N, Scope *  scope, Token *
 
 	Symbol *	newSymbol;
 
-	newSymbol = (Symbol *)calloc(1, sizeof(Symbol));
-	if (newSymbol == NULL)
-	{
-		fatal(N, Emalloc);
-	}
+	newSymbol = (Symbol *)arenaAllocate(N, sizeof(Symbol));
 
 	newSymbol->identifier	= token->identifier;
 	newSymbol->sourceInfo	= token->sourceInfo;
@@ -98,19 +295,7 @@ commonSymbolTableAddOrLookupSymbolForToken(State *  N, Scope *  scope, Token *
 	 *	NOTE:	Caller sets (1) intconst/etc. fields, (2) type, based on context.
 	 *		Caller sets the typesig based on the parsed typeexpr for defns.
 	 */
-	if (scope->firstSymbol == NULL)
-	{
-		scope->firstSymbol = newSymbol;
-	}
-	else
-	{
-		Symbol *	p = scope->firstSymbol;
-		while (p->next != NULL)
-		{
-			p = p->next;
-		}
-		p->next = newSymbol;
-	}
+	commonSymbolTableInsertSymbol(N, scope, newSymbol);
 
 	return newSymbol;
 }
@@ -121,49 +306,35 @@ commonSymbolTableSymbolForIdentifier(State *  N, Scope *  scope, const char *  i
 {
 //	TimeStampTraceMacro(kNoisyTimeStampKeySymbolTableSymbolForIdentifier);
 
-	/*
-	 *	Recursion falls out when we reach root which has nil parent,
-	 *	and this is the point at which we check the module scopes:
-	 */
-	if (scope == NULL)
-	{
-		Scope *	moduleScope = N->moduleScopes;
-
-		// while (moduleScope != NULL)
-		// {
-		if (moduleScope != NULL)
-		{
-			Symbol *	moduleSym = moduleScope->firstSymbol;
-
-			while (moduleSym != NULL)
-			{
-				if (!strcmp(moduleSym->identifier, identifier))
-				{
-					return moduleSym;
-				}
-				moduleSym = moduleSym->next;
-			}
-		}
-			// moduleScope = moduleScope->next;
-		// }
+	const char *	interned = commonSymbolTableLookupInternedIdentifier(N, identifier);
 
+	if (interned == NULL)
+	{
 		return NULL;
 	}
 
 	/*
 	 *	Search current and parent (not siblings or children)
 	 */
-	Symbol *	sym = scope->firstSymbol;
-	while (sym != NULL)
+	for (; scope != NULL; scope = scope->parent)
 	{
-		if (!strcmp(sym->identifier, identifier))
+		Symbol *	sym = commonSymbolTableScopeLookup(scope, interned);
+
+		if (sym != NULL)
 		{
 			return sym;
 		}
-		sym = sym->next;
 	}
 
-	return commonSymbolTableSymbolForIdentifier(N, scope->parent, identifier);
+	/*
+	 *	Past the root, which has nil parent, we check the module scopes:
+	 */
+	if (N->moduleScopes != NULL)
+	{
+		return commonSymbolTableScopeLookup(N->moduleScopes, interned);
+	}
+
+	return NULL;
 }
 
 
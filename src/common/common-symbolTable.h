@@ -41,6 +41,9 @@
 Scope *		commonSymbolTableAllocScope(State *  N);
 Symbol *	commonSymbolTableAddOrLookupSymbolForToken(State *  N, Scope *  scope, Token *  token);
 Symbol *	commonSymbolTableSymbolForIdentifier(State *  N, Scope *  scope, const char *  identifier);
+void		commonSymbolTableInsertSymbol(State *  N, Scope *  scope, Symbol *  symbol);
+const char *	commonSymbolTableInternIdentifier(State *  N, const char *  identifier);
+const char *	commonSymbolTableLookupInternedIdentifier(State *  N, const char *  identifier);
 Scope *		commonSymbolTableGetScopeWithName(State * N, Scope * scope, const char * identifier);
 Scope *		commonSymbolTableOpenScope(State *  N, Scope *  scope, IrNode *  subtree);
 void		commonSymbolTableCloseScope(State *  N, Scope *  scope, IrNode *  subtree);
\ No newline at end of file
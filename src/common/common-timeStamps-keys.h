@@ -51,6 +51,7 @@
 	kCommonTimeStampKeyLexAllocateToken,
 	kCommonTimeStampKeyLexDebugPrintToken,
 	kCommonTimeStampKeyLexGet,
+	kCommonTimeStampKeyLexMapSource,
 	kCommonTimeStampKeyLexPeek,
 	kCommonTimeStampKeyLexPeekPrint,
 	kCommonTimeStampKeyLexPrintToken,
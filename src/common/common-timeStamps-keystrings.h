@@ -50,6 +50,7 @@
 	[	kCommonTimeStampKeyLexAllocateToken]			"kCommonTimeStampKeyLexAllocateToken",
 	[	kCommonTimeStampKeyLexDebugPrintToken]			"kCommonTimeStampKeyLexDebugPrintToken",
 	[	kCommonTimeStampKeyLexGet]				"kCommonTimeStampKeyLexGet",
+	[	kCommonTimeStampKeyLexMapSource]			"kCommonTimeStampKeyLexMapSource",
 	[	kCommonTimeStampKeyLexPeekPrint]			"kCommonTimeStampKeyLexPeekPrint",
 	[	kCommonTimeStampKeyLexPeek]				"kCommonTimeStampKeyLexPeek",
 	[	kCommonTimeStampKeyLexPrintToken]			"kCommonTimeStampKeyLexPrintToken",
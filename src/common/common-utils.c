@@ -395,7 +395,113 @@ dealloc(State *  N)
 		free(N->callAggregates);
 	}
 
-	//TODO: recursively free all the nodes
+	/*
+	 *	The nodes all live in the arena
+	 */
+	arenaRelease(N);
+}
+
+
+
+/*
+ *	Allocate zeroed memory for a front-end node from the arena of N.
+ *	Allocations larger than a block get a block of their own, which
+ *	is chained behind the current one so its free space isn't lost.
+ */
+void *
+arenaAllocate(State *  N, size_t size)
+{
+	ArenaBlock *	block = N->arena;
+	void *		allocation;
+
+	size = (size + kCommonArenaAlignment - 1) & ~((size_t)kCommonArenaAlignment - 1);
+	if (block == NULL || block->used + size > block->size)
+	{
+		size_t	blockSize = (size > kCommonArenaBlockBytes ? size : kCommonArenaBlockBytes);
+
+		block = (ArenaBlock *)malloc(sizeof(ArenaBlock) + blockSize);
+		if (block == NULL)
+		{
+			fatal(N, Emalloc);
+		}
+		block->size	= blockSize;
+		block->used	= 0;
+
+		if (N->arena != NULL && blockSize > kCommonArenaBlockBytes)
+		{
+			block->next		= N->arena->next;
+			N->arena->next		= block;
+		}
+		else
+		{
+			block->next		= N->arena;
+			N->arena		= block;
+		}
+	}
+
+	allocation = (char *)block->data + block->used;
+	block->used += size;
+	memset(allocation, 0, size);
+
+	return allocation;
+}
+
+
+
+char *
+arenaStrndup(State *  N, const char *  string, size_t length)
+{
+	char *	copy = (char *)arenaAllocate(N, length + 1);
+
+	memcpy(copy, string, length);
+
+	return copy;
+}
+
+char *
+arenaStrdup(State *  N, const char *  string)
+{
+	size_t	length = strlen(string) + 1;
+	char *	copy = arenaAllocate(N, length);
+
+	memcpy(copy, string, length);
+
+	return copy;
+}
+
+
+
+/*
+ *	Free all the blocks of the arena. The nodes allocated from it,
+ *	including the token list and IR trees hanging off N, are gone.
+ */
+void
+arenaRelease(State *  N)
+{
+	ArenaBlock *	block = N->arena;
+
+	while (block != NULL)
+	{
+		ArenaBlock *	next = block->next;
+
+		free(block);
+		block = next;
+	}
+
+	N->arena		= NULL;
+	N->internTable		= NULL;
+	N->internTableBucketCount	= 0;
+	N->internTableUsed	= 0;
+	N->tokenBuffer		= NULL;
+	N->tokenBufferSize	= 0;
+	N->tokenCount		= 0;
+	N->tokenIndex		= 0;
+	N->currentFunction	= NULL;
+	N->moduleScopes		= NULL;
+	N->noisyIrRoot		= NULL;
+	N->newtonIrRoot		= NULL;
+	N->noisyIrTopScope	= NULL;
+	N->newtonIrTopScope	= NULL;
 }
 
 
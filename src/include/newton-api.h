@@ -1,4 +1,5 @@
 State * newtonApiInit(char *  newtonFileName);
+void newtonApiDealloc(State *  N);
 Physics* newtonApiGetPhysicsTypeByName(State* N, char* nameOfType);
 Physics * newtonApiGetPhysicsTypeByNameAndSubindex(State* N, char* nameOfType, int subindex);
 NewtonAPIReport* newtonApiSatisfiesConstraints(State* N, IrNode* parameterTreeRoot);
@@ -114,6 +114,10 @@ main(int argc, char *argv[])
 			{"process",		required_argument,	0,	421},
 			{"measurement",		required_argument,	0,	422},
 			{"auto-diff",		no_argument,		0,	423},
+			{"llvm-ir-relational",	required_argument,	0,	424},
+			{"llvm-ir-error-budget",	required_argument,	0,	425},
+			{"llvm-ir-vectorize-shrink",	no_argument,		0,	426},
+			{"llvm-ir-specialization-budget",	required_argument,	0,	427},
 			{"ipsa",		required_argument,	0,	489},
 			{"kernelNumber",	required_argument,	0,	494},
 			{"piNumber",		required_argument,	0,	495},
@@ -410,6 +414,70 @@ main(int argc, char *argv[])
 				break;
 			}
 
+			case 424:
+			{
+				/*
+				 *	Comma-separated functions, or "all", whose comparisons the
+				 *	range analysis also decides with the difference bounds
+				 */
+				N->llvmIRRelationalFunctions = optarg;
+				break;
+			}
+
+			case 425:
+			{
+				/*
+				 *	Largest absolute error of the floating-point outputs, the precision
+				 *	analysis chooses the representation of each value within it
+				 */
+				double tmpDouble = strtod(optarg, &ep);
+				if (*ep == '\0' && tmpDouble > 0)
+				{
+					N->llvmIRErrorBudget = tmpDouble;
+					N->irPasses |= kNewtonirPassLLVMIROptimizeByRange;
+				}
+				else
+				{
+					usage(N);
+					consolePrintBuffers(N);
+					exit(EXIT_FAILURE);
+				}
+
+				break;
+			}
+
+			case 426:
+			{
+				/*
+				 *	Shrink the types of the LLVM IR for the SIMD lanes of the target
+				 */
+				N->llvmIRVectorizeShrink = true;
+				N->irPasses |= kNewtonirPassLLVMIROptimizeByRange;
+
+				break;
+			}
+
+			case 427:
+			{
+				/*
+				 *	Largest code growth by the specialized functions, in percent
+				 */
+				uint64_t tmpInt = strtoul(optarg, &ep, 0);
+				if (*ep == '\0')
+				{
+					N->llvmIRSpecializationBudget = tmpInt;
+					N->irPasses |= kNewtonirPassLLVMIROptimizeByRange;
+				}
+				else
+				{
+					usage(N);
+					consolePrintBuffers(N);
+					exit(EXIT_FAILURE);
+				}
+
+				break;
+			}
+
 			case 'I':
 			{
 				N->irPasses |= kNewtonIrPassLLVMIRDimensionCheck;
@@ -426,7 +494,11 @@ main(int argc, char *argv[])
 
             case 'Q':
             {
+                /*
+                 *	The quantization uses the ranges of the range analysis
+                 */
                 N->irPasses |= kNewtonirPassLLVMIRAutoQuantization;
+                N->irPasses |= kNewtonirPassLLVMIROptimizeByRange;
                 break;
             }
 
@@ -541,6 +613,11 @@ main(int argc, char *argv[])
 		consolePrintBuffers(N);
 	}
 
+	/*
+	 *	Release the arena backing the tokens, IR and symbol tables in one go.
+	 */
+	dealloc(N);
+
 	return 0;
 }
 
@@ -565,6 +642,10 @@ usage(State *  N)
 						"                | (--smt <path to output file>, -S <path to output file>)    \n"
 						"                | (--bytecode <output file name>, -b <output file name>)     \n"
 						"                | (--optimize <level>, -O <level>)                           \n"
+						"                | (--llvm-ir-relational=<function names separated by , or all>)\n"
+						"                | (--llvm-ir-error-budget=<largest absolute error of the outputs>)\n"
+						"                | (--llvm-ir-vectorize-shrink)                               \n"
+						"                | (--llvm-ir-specialization-budget=<percent of code growth>) \n"
 						"                | (--dmatrixannote, -m)                                      \n"
 						"                | (--pigroups, -p)                                           \n"
 						"                | (--pigroupsfrombody, -i)                                   \n"
@@ -79,6 +79,13 @@ newtonApiInit(char * newtonFileName)
     return N;
 }
 
+void
+newtonApiDealloc(State *  N)
+{
+    dealloc(N);
+    free(N);
+}
+
 Physics *
 newtonApiGetPhysicsTypeByNameAndSubindex(State * N, char * nameOfType, int subindex)
 {
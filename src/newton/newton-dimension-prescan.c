@@ -101,7 +101,7 @@ newtonDimensionPassParseFile(State *  N, Scope *  currentScope)
 	/*
 	 *	Skip eof token without using lexGet
 	 */
-	N->tokenList = N->tokenList->next;
+	N->tokenIndex++;
 }
 
 void
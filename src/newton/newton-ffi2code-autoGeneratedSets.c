@@ -996,7 +996,7 @@ int    gNewtonFirsts[kCommonIrNodeTypeMax][kCommonIrNodeTypeMax]  = {
                                                [kNewtonIrNodeType_Twrite                        ]            = {kNewtonIrNodeType_Twrite, kNewtonIrNodeTypeMax},
                                     };
 
-int    gNewtonFollows[kNewtonIrNodeTypeMax][kNewtonIrNodeTypeMax]  = {
+int    gNewtonFollows[kCommonIrNodeTypeMax][kCommonIrNodeTypeMax]  = {
                                                [kNewtonIrNodeType_PunaryOp                      ]            = {
                                                                                                                     kNewtonIrNodeType_TintegerConst,
                                                                                                                     kNewtonIrNodeType_TrealConst,
@@ -35,6 +35,6 @@
 	POSSIBILITY OF SUCH DAMAGE.
 */
 
-int	gNewtonFirsts[kNoisyIrNodeTypeMax][kNoisyIrNodeTypeMax];
-int	gNewtonFollows[kNoisyIrNodeTypeMax][kNoisyIrNodeTypeMax];
+int	gNewtonFirsts[kCommonIrNodeTypeMax][kCommonIrNodeTypeMax];
+int	gNewtonFollows[kCommonIrNodeTypeMax][kCommonIrNodeTypeMax];
 char *	gNewtonAstNodeStrings[kNoisyIrNodeTypeMax];
@@ -156,11 +156,11 @@ memoryAlignment(State * N, BoundInfo * boundInfo, llvm::Function & llvmIrFunctio
 						break;
 
 					}
+					break;
 				}
 
 				case Instruction::Alloca:
 				{
-					llvmIrInstruction->print(llvm::outs());
 					llvm::AllocaInst* allocaInst = llvm::dyn_cast<llvm::AllocaInst>(llvmIrInstruction);
 					llvm::Type *type = allocaInst->getAllocatedType();
 					if (isa<ArrayType>(type)){
@@ -181,6 +181,560 @@ memoryAlignment(State * N, BoundInfo * boundInfo, llvm::Function & llvmIrFunctio
 		}
 	}
 }
+
+/*
+ * the fields of the structures from the outermost one to a member,
+ * the elements of an array share the path of the array
+ * */
+typedef std::vector<unsigned> FieldPath;
+
+typedef struct LayoutLeaf {
+	std::pair<double, double> range;
+	bool			  hasRange	 = false;
+	/*
+	 * every value stored to the member has a range
+	 * */
+	bool			  isNarrowable	 = true;
+	llvm::IntegerType *	  narrowType	 = nullptr;
+	bool			  isSigned	 = false;
+} LayoutLeaf;
+
+/*
+ * the members of a global variable or a stack variable, and the order of the fields of each of its structures
+ * */
+typedef struct CompactLayout {
+	std::map<FieldPath, LayoutLeaf>		    leaves;
+	/*
+	 * the new index of each field of the structure at a path
+	 * */
+	std::map<FieldPath, std::vector<unsigned>> fieldIndex;
+} CompactLayout;
+
+enum LayoutLimit {
+	NarrowestLeafBits = 8,
+};
+
+void
+joinLeafRange(LayoutLeaf & leaf, const std::pair<double, double> & range)
+{
+	leaf.range    = leaf.hasRange ? std::make_pair(min(leaf.range.first, range.first), max(leaf.range.second, range.second))
+				      : range;
+	leaf.hasRange = true;
+}
+
+/*
+ * collect the members accessed through `pointer` and the ranges of the values stored to them.
+ * Fails if the memory is accessed other than by loading and storing its members,
+ * e.g. it's passed to a function or copied with memcpy, as the layout of the memory changes.
+ * */
+bool
+collectLayoutAccesses(llvm::Value * pointer, llvm::Type * pointeeType, const FieldPath & path, bool isInArray,
+		      std::map<std::string, BoundInfo *> & funcBoundInfo, CompactLayout & layout)
+{
+	for (llvm::User * pointerUser : pointer->users())
+	{
+		if (auto gepOperator = dyn_cast<llvm::GEPOperator>(pointerUser))
+		{
+			if (gepOperator->getPointerOperand() != pointer || gepOperator->getSourceElementType() != pointeeType ||
+			    gepOperator->getNumOperands() < 2)
+				return false;
+			/*
+			 * only a pointer to an element of an array can move to the other elements
+			 * */
+			auto firstIndex = dyn_cast<llvm::ConstantInt>(gepOperator->getOperand(1));
+			if ((firstIndex == nullptr || !firstIndex->isZero()) && !(isInArray && gepOperator->isInBounds()))
+				return false;
+			FieldPath    elementPath     = path;
+			llvm::Type * elementType     = pointeeType;
+			bool	     isElementInArray = isInArray;
+			for (unsigned idx = 2; idx < gepOperator->getNumOperands(); idx++)
+			{
+				if (auto structType = dyn_cast<llvm::StructType>(elementType))
+				{
+					auto fieldIndex = dyn_cast<llvm::ConstantInt>(gepOperator->getOperand(idx));
+					if (fieldIndex == nullptr)
+						return false;
+					elementPath.emplace_back(fieldIndex->getZExtValue());
+					elementType	 = structType->getElementType(fieldIndex->getZExtValue());
+					isElementInArray = false;
+				}
+				else if (auto arrayType = dyn_cast<llvm::ArrayType>(elementType))
+				{
+					elementType	 = arrayType->getElementType();
+					isElementInArray = true;
+				}
+				else
+				{
+					return false;
+				}
+			}
+			if (!collectLayoutAccesses(gepOperator, elementType, elementPath, isElementInArray, funcBoundInfo, layout))
+				return false;
+		}
+		else if (auto llvmIrLoadInstruction = dyn_cast<llvm::LoadInst>(pointerUser))
+		{
+			if (llvmIrLoadInstruction->isVolatile() || llvmIrLoadInstruction->getType() != pointeeType ||
+			    pointeeType->isAggregateType())
+				return false;
+			layout.leaves[path];
+		}
+		else if (auto llvmIrStoreInstruction = dyn_cast<llvm::StoreInst>(pointerUser))
+		{
+			llvm::Value * storedValue = llvmIrStoreInstruction->getValueOperand();
+			if (llvmIrStoreInstruction->isVolatile() || storedValue == pointer ||
+			    storedValue->getType() != pointeeType || pointeeType->isAggregateType())
+				return false;
+			LayoutLeaf & leaf = layout.leaves[path];
+			if (!pointeeType->isIntegerTy())
+				continue;
+			auto			  fbIt = funcBoundInfo.find(llvmIrStoreInstruction->getFunction()->getName().str());
+			std::pair<double, double> storedRange;
+			if (fbIt != funcBoundInfo.end() && getValueRange(storedValue, fbIt->second, storedRange))
+				joinLeafRange(leaf, storedRange);
+			else
+				leaf.isNarrowable = false;
+		}
+		else
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+/*
+ * join the values of the initializer of a global variable to its members
+ * */
+void
+collectInitializerRange(llvm::Constant * initializer, llvm::Type * type, FieldPath & path, CompactLayout & layout)
+{
+	if (isa<llvm::UndefValue>(initializer))
+	{
+		return;
+	}
+	if (auto structType = dyn_cast<llvm::StructType>(type))
+	{
+		for (unsigned idx = 0; idx < structType->getNumElements(); idx++)
+		{
+			path.emplace_back(idx);
+			collectInitializerRange(initializer->getAggregateElement(idx), structType->getElementType(idx), path, layout);
+			path.pop_back();
+		}
+	}
+	else if (auto arrayType = dyn_cast<llvm::ArrayType>(type))
+	{
+		/*
+		 * the elements of a zero initializer are all the same
+		 * */
+		uint64_t elementNum = isa<llvm::ConstantAggregateZero>(initializer) ? min(arrayType->getNumElements(), (uint64_t)1)
+										       : arrayType->getNumElements();
+		for (uint64_t idx = 0; idx < elementNum; idx++)
+		{
+			collectInitializerRange(initializer->getAggregateElement(idx), arrayType->getElementType(), path, layout);
+		}
+	}
+	else if (type->isIntegerTy())
+	{
+		LayoutLeaf & leaf = layout.leaves[path];
+		if (auto constInt = dyn_cast<llvm::ConstantInt>(initializer))
+		{
+			double constValue = static_cast<double>(constInt->getSExtValue());
+			joinLeafRange(leaf, std::make_pair(constValue, constValue));
+		}
+		else if (isa<llvm::ConstantAggregateZero>(initializer) || initializer->isNullValue())
+		{
+			joinLeafRange(leaf, std::make_pair(0.0, 0.0));
+		}
+		else
+		{
+			leaf.isNarrowable = false;
+		}
+	}
+}
+
+/*
+ * the type of the memory with the narrow members, and the fields of each structure ordered by their alignment,
+ * so that no padding is needed between them
+ * */
+llvm::Type *
+getCompactType(llvm::Type * type, FieldPath & path, CompactLayout & layout, const llvm::DataLayout & dataLayout)
+{
+	if (auto structType = dyn_cast<llvm::StructType>(type))
+	{
+		std::vector<llvm::Type *> fieldTypes;
+		for (unsigned idx = 0; idx < structType->getNumElements(); idx++)
+		{
+			path.emplace_back(idx);
+			fieldTypes.emplace_back(getCompactType(structType->getElementType(idx), path, layout, dataLayout));
+			path.pop_back();
+		}
+		std::vector<unsigned> fieldOrder(fieldTypes.size());
+		std::iota(fieldOrder.begin(), fieldOrder.end(), 0);
+		if (!structType->isPacked())
+		{
+			std::stable_sort(fieldOrder.begin(), fieldOrder.end(), [&](unsigned lhs, unsigned rhs) {
+				return dataLayout.getABITypeAlign(fieldTypes[lhs]) > dataLayout.getABITypeAlign(fieldTypes[rhs]);
+			});
+		}
+		std::vector<llvm::Type *> orderedTypes;
+		std::vector<unsigned> &	  fieldIndex = layout.fieldIndex[path];
+		fieldIndex.resize(fieldTypes.size());
+		for (unsigned newIndex = 0; newIndex < fieldOrder.size(); newIndex++)
+		{
+			fieldIndex[fieldOrder[newIndex]] = newIndex;
+			orderedTypes.emplace_back(fieldTypes[fieldOrder[newIndex]]);
+		}
+		if (structType->hasName())
+			return llvm::StructType::create(type->getContext(), orderedTypes, structType->getName().str() + ".compact",
+							structType->isPacked());
+		return llvm::StructType::get(type->getContext(), orderedTypes, structType->isPacked());
+	}
+	if (auto arrayType = dyn_cast<llvm::ArrayType>(type))
+	{
+		return llvm::ArrayType::get(getCompactType(arrayType->getElementType(), path, layout, dataLayout),
+					    arrayType->getNumElements());
+	}
+	auto leafIt = layout.leaves.find(path);
+	if (leafIt != layout.leaves.end() && leafIt->second.narrowType != nullptr)
+	{
+		return leafIt->second.narrowType;
+	}
+	return type;
+}
+
+/*
+ * the initializer of a global variable in its compact type
+ * */
+llvm::Constant *
+getCompactInitializer(llvm::Constant * initializer, llvm::Type * type, llvm::Type * compactType, FieldPath & path,
+		      CompactLayout & layout)
+{
+	if (type == compactType)
+	{
+		return initializer;
+	}
+	if (isa<llvm::UndefValue>(initializer))
+	{
+		return llvm::UndefValue::get(compactType);
+	}
+	if (isa<llvm::ConstantAggregateZero>(initializer))
+	{
+		return llvm::ConstantAggregateZero::get(compactType);
+	}
+	if (auto structType = dyn_cast<llvm::StructType>(type))
+	{
+		auto				 compactStructType = cast<llvm::StructType>(compactType);
+		std::vector<llvm::Constant *> fields(structType->getNumElements());
+		std::vector<unsigned>		 fieldIndex = layout.fieldIndex[path];
+		for (unsigned idx = 0; idx < structType->getNumElements(); idx++)
+		{
+			path.emplace_back(idx);
+			fields[fieldIndex[idx]] = getCompactInitializer(initializer->getAggregateElement(idx), structType->getElementType(idx),
+								       compactStructType->getElementType(fieldIndex[idx]), path, layout);
+			path.pop_back();
+		}
+		return llvm::ConstantStruct::get(compactStructType, fields);
+	}
+	if (auto arrayType = dyn_cast<llvm::ArrayType>(type))
+	{
+		auto				 compactArrayType = cast<llvm::ArrayType>(compactType);
+		std::vector<llvm::Constant *> elements;
+		for (uint64_t idx = 0; idx < arrayType->getNumElements(); idx++)
+		{
+			elements.emplace_back(getCompactInitializer(initializer->getAggregateElement(idx), arrayType->getElementType(),
+								    compactArrayType->getElementType(), path, layout));
+		}
+		return llvm::ConstantArray::get(compactArrayType, elements);
+	}
+	return llvm::ConstantExpr::getIntegerCast(initializer, compactType, layout.leaves[path].isSigned);
+}
+
+/*
+ * move the range of a value to the value replacing it
+ * */
+void
+moveValueRange(BoundInfo * boundInfo, llvm::Value * value, const std::vector<llvm::Value *> & newValues)
+{
+	if (boundInfo == nullptr)
+	{
+		return;
+	}
+	auto vrIt = boundInfo->virtualRegisterRange.find(value);
+	if (vrIt == boundInfo->virtualRegisterRange.end())
+	{
+		return;
+	}
+	std::pair<double, double> range = vrIt->second;
+	boundInfo->virtualRegisterRange.erase(vrIt);
+	for (llvm::Value * newValue : newValues)
+	{
+		if (!isa<llvm::Constant>(newValue))
+			boundInfo->virtualRegisterRange.emplace(newValue, range);
+	}
+}
+
+/*
+ * rewrite the accesses through `pointer` to the accesses through `compactPointer`:
+ * the indices of the fields follow the new order, the loads extend the narrow members
+ * and the stores truncate the values to them
+ * */
+void
+rewriteLayoutAccesses(llvm::Value * pointer, llvm::Value * compactPointer, llvm::Type * pointeeType, llvm::Type * compactPointeeType,
+		      const FieldPath & path, std::map<std::string, BoundInfo *> & funcBoundInfo, CompactLayout & layout)
+{
+	std::vector<llvm::User *> pointerUsers(pointer->user_begin(), pointer->user_end());
+	for (llvm::User * pointerUser : pointerUsers)
+	{
+		auto llvmIrInstruction = dyn_cast<llvm::Instruction>(pointerUser);
+		BoundInfo * boundInfo  = nullptr;
+		if (llvmIrInstruction != nullptr)
+		{
+			auto fbIt = funcBoundInfo.find(llvmIrInstruction->getFunction()->getName().str());
+			boundInfo = fbIt != funcBoundInfo.end() ? fbIt->second : nullptr;
+		}
+		if (auto gepOperator = dyn_cast<llvm::GEPOperator>(pointerUser))
+		{
+			FieldPath		   elementPath	      = path;
+			llvm::Type *		   elementType	      = pointeeType;
+			llvm::Type *		   compactElementType = compactPointeeType;
+			std::vector<llvm::Value *> indexValues{gepOperator->getOperand(1)};
+			for (unsigned idx = 2; idx < gepOperator->getNumOperands(); idx++)
+			{
+				if (auto structType = dyn_cast<llvm::StructType>(elementType))
+				{
+					unsigned field	   = cast<llvm::ConstantInt>(gepOperator->getOperand(idx))->getZExtValue();
+					unsigned newField  = layout.fieldIndex[elementPath][field];
+					indexValues.emplace_back(llvm::ConstantInt::get(llvm::Type::getInt32Ty(pointer->getContext()), newField));
+					elementPath.emplace_back(field);
+					elementType	   = structType->getElementType(field);
+					compactElementType = cast<llvm::StructType>(compactElementType)->getElementType(newField);
+				}
+				else
+				{
+					indexValues.emplace_back(gepOperator->getOperand(idx));
+					elementType	   = elementType->getArrayElementType();
+					compactElementType = compactElementType->getArrayElementType();
+				}
+			}
+			llvm::Value * compactElement;
+			if (llvmIrInstruction != nullptr)
+			{
+				llvm::IRBuilder<> Builder(llvmIrInstruction);
+				compactElement = gepOperator->isInBounds()
+							 ? Builder.CreateInBoundsGEP(compactPointeeType, compactPointer, indexValues)
+							 : Builder.CreateGEP(compactPointeeType, compactPointer, indexValues);
+			}
+			else
+			{
+				compactElement = llvm::ConstantExpr::getGetElementPtr(compactPointeeType, cast<llvm::Constant>(compactPointer),
+										     indexValues, gepOperator->isInBounds());
+			}
+			rewriteLayoutAccesses(gepOperator, compactElement, elementType, compactElementType, elementPath, funcBoundInfo, layout);
+			if (llvmIrInstruction != nullptr)
+			{
+				compactElement->takeName(llvmIrInstruction);
+				moveValueRange(boundInfo, llvmIrInstruction, {compactElement});
+				llvmIrInstruction->eraseFromParent();
+			}
+			continue;
+		}
+
+		llvm::IRBuilder<> Builder(llvmIrInstruction);
+		const LayoutLeaf & leaf = layout.leaves[path];
+		if (auto llvmIrLoadInstruction = dyn_cast<llvm::LoadInst>(llvmIrInstruction))
+		{
+			llvm::Align compactAlign = llvm::commonAlignment(llvmIrLoadInstruction->getAlign(),
+									 llvmIrInstruction->getModule()->getDataLayout().getABITypeAlign(compactPointeeType).value());
+			llvm::LoadInst * compactLoad  = Builder.CreateAlignedLoad(compactPointeeType, compactPointer, compactAlign);
+			llvm::Value *	 extendValue = compactPointeeType == pointeeType
+							       ? compactLoad
+							       : Builder.CreateIntCast(compactLoad, pointeeType, leaf.isSigned);
+			/*
+			 * the struct-path `!tbaa` describes the old layout, and `!range` the old type of the member
+			 * */
+			compactLoad->copyMetadata(*llvmIrLoadInstruction);
+			compactLoad->setMetadata(llvm::LLVMContext::MD_tbaa, nullptr);
+			if (compactPointeeType != pointeeType)
+				compactLoad->setMetadata(llvm::LLVMContext::MD_range, nullptr);
+			extendValue->takeName(llvmIrLoadInstruction);
+			moveValueRange(boundInfo, llvmIrLoadInstruction, {compactLoad, extendValue});
+			llvmIrLoadInstruction->replaceAllUsesWith(extendValue);
+		}
+		else
+		{
+			auto		llvmIrStoreInstruction = cast<llvm::StoreInst>(llvmIrInstruction);
+			llvm::Value *	storedValue	       = llvmIrStoreInstruction->getValueOperand();
+			llvm::Value *	truncateValue	       = compactPointeeType == pointeeType
+								 ? storedValue
+								 : Builder.CreateIntCast(storedValue, compactPointeeType, leaf.isSigned);
+			llvm::Align	compactAlign	       = llvm::commonAlignment(llvmIrStoreInstruction->getAlign(),
+									       llvmIrInstruction->getModule()->getDataLayout().getABITypeAlign(compactPointeeType).value());
+			if (truncateValue != storedValue && boundInfo != nullptr && !isa<llvm::Constant>(truncateValue))
+			{
+				auto vrIt = boundInfo->virtualRegisterRange.find(storedValue);
+				if (vrIt != boundInfo->virtualRegisterRange.end())
+					boundInfo->virtualRegisterRange.emplace(truncateValue, vrIt->second);
+			}
+			llvm::StoreInst * compactStore = Builder.CreateAlignedStore(truncateValue, compactPointer, compactAlign);
+			compactStore->copyMetadata(*llvmIrStoreInstruction);
+			compactStore->setMetadata(llvm::LLVMContext::MD_tbaa, nullptr);
+		}
+		llvmIrInstruction->eraseFromParent();
+	}
+}
+
+/*
+ * the members of the memory and their narrowest type, fails if the layout can't change
+ * */
+bool
+getCompactLayout(llvm::Value * memory, llvm::Type * memoryType, llvm::Constant * initializer,
+		 std::map<std::string, BoundInfo *> & funcBoundInfo, CompactLayout & layout)
+{
+	FieldPath path;
+	if (!memoryType->isSized() || !collectLayoutAccesses(memory, memoryType, path, false, funcBoundInfo, layout))
+	{
+		return false;
+	}
+	if (initializer != nullptr)
+	{
+		collectInitializerRange(initializer, memoryType, path, layout);
+	}
+	for (auto & leafPair : layout.leaves)
+	{
+		LayoutLeaf & leaf = leafPair.second;
+		/*
+		 * the path only identifies the member, its type is where it leads to
+		 * */
+		llvm::Type * leafType = memoryType;
+		for (unsigned field : leafPair.first)
+		{
+			while (leafType->isArrayTy())
+				leafType = leafType->getArrayElementType();
+			leafType = cast<llvm::StructType>(leafType)->getElementType(field);
+		}
+		while (leafType->isArrayTy())
+			leafType = leafType->getArrayElementType();
+		if (!leafType->isIntegerTy() || !leaf.isNarrowable || !leaf.hasRange)
+			continue;
+		leaf.isSigned = leaf.range.first < 0;
+		for (unsigned bits = NarrowestLeafBits; bits < leafType->getIntegerBitWidth(); bits *= 2)
+		{
+			double lowerBound = leaf.isSigned ? -std::ldexp(1.0, bits - 1) : 0;
+			double upperBound = leaf.isSigned ? std::ldexp(1.0, bits - 1) - 1 : std::ldexp(1.0, bits) - 1;
+			if (leaf.range.first >= lowerBound && leaf.range.second <= upperBound)
+			{
+				leaf.narrowType = llvm::IntegerType::get(memoryType->getContext(), bits);
+				break;
+			}
+		}
+	}
+	return true;
+}
+
+/*
+ * Steps of compactDataLayout:
+ *  1. for each internal global variable and each stack variable, collect the members its loads and stores access
+ *     and join the ranges of the values stored to each member (and of the initializer of a global variable)
+ *  2. narrow each integer member to the narrowest type holding its range
+ *  3. order the fields of each structure by their alignment to remove the padding between them
+ *  4. if the memory gets smaller, move it to the compact type and rewrite its GEPs, loads and stores
+ * The layout of a variable whose address escapes, e.g. to a call or a memcpy, is kept.
+ * */
+void
+compactDataLayout(State * N, llvm::Module & llvmIrModule, BoundInfo * globalBoundInfo,
+		  std::map<std::string, BoundInfo *> & funcBoundInfo,
+		  std::map<llvm::Value *, std::vector<std::pair<double, double>>> & virtualRegisterVectorRange)
+{
+	const llvm::DataLayout & dataLayout = llvmIrModule.getDataLayout();
+
+	std::vector<llvm::GlobalVariable *> globalVariables;
+	for (llvm::GlobalVariable & globalVar : llvmIrModule.globals())
+	{
+		if (globalVar.hasLocalLinkage() && globalVar.hasDefinitiveInitializer() && !globalVar.hasSection())
+			globalVariables.emplace_back(&globalVar);
+	}
+	for (llvm::GlobalVariable * globalVar : globalVariables)
+	{
+		CompactLayout layout;
+		llvm::Type *  valueType = globalVar->getValueType();
+		globalVar->removeDeadConstantUsers();
+		if (!getCompactLayout(globalVar, valueType, globalVar->getInitializer(), funcBoundInfo, layout))
+			continue;
+		FieldPath    path;
+		llvm::Type * compactType = getCompactType(valueType, path, layout, dataLayout);
+		uint64_t     size	 = dataLayout.getTypeAllocSize(valueType);
+		uint64_t     compactSize = dataLayout.getTypeAllocSize(compactType);
+		if (compactSize >= size)
+			continue;
+		flexprint(N->Fe, N->Fm, N->Fpinfo, "\tcompact data layout: @%s, %lu -> %lu bytes\n", globalVar->getName().str().c_str(),
+			  size, compactSize);
+
+		auto compactGlobal = new llvm::GlobalVariable(llvmIrModule, compactType, globalVar->isConstant(), globalVar->getLinkage(),
+							      getCompactInitializer(globalVar->getInitializer(), valueType, compactType, path, layout),
+							      "", globalVar, globalVar->getThreadLocalMode(), globalVar->getAddressSpace());
+		compactGlobal->copyAttributesFrom(globalVar);
+		rewriteLayoutAccesses(globalVar, compactGlobal, valueType, compactType, path, funcBoundInfo, layout);
+		globalVar->removeDeadConstantUsers();
+		for (auto & fbPair : funcBoundInfo)
+		{
+			moveValueRange(fbPair.second, globalVar, {});
+		}
+		moveValueRange(globalBoundInfo, globalVar, {compactGlobal});
+		auto vrvIt = virtualRegisterVectorRange.find(globalVar);
+		if (vrvIt != virtualRegisterVectorRange.end())
+		{
+			virtualRegisterVectorRange.emplace(compactGlobal, vrvIt->second);
+			virtualRegisterVectorRange.erase(vrvIt);
+		}
+		compactGlobal->takeName(globalVar);
+		globalVar->eraseFromParent();
+	}
+
+	for (llvm::Function & llvmIrFunction : llvmIrModule)
+	{
+		auto fbIt = funcBoundInfo.find(llvmIrFunction.getName().str());
+		if (llvmIrFunction.isDeclaration() || fbIt == funcBoundInfo.end())
+			continue;
+		std::vector<llvm::AllocaInst *> allocaInstructions;
+		for (llvm::Instruction & llvmIrInstruction : llvmIrFunction.getEntryBlock())
+		{
+			auto llvmIrAllocaInstruction = dyn_cast<llvm::AllocaInst>(&llvmIrInstruction);
+			if (llvmIrAllocaInstruction != nullptr && llvmIrAllocaInstruction->isStaticAlloca() &&
+			    !llvmIrAllocaInstruction->isArrayAllocation())
+				allocaInstructions.emplace_back(llvmIrAllocaInstruction);
+		}
+		for (llvm::AllocaInst * llvmIrAllocaInstruction : allocaInstructions)
+		{
+			CompactLayout layout;
+			llvm::Type *  allocatedType = llvmIrAllocaInstruction->getAllocatedType();
+			if (!getCompactLayout(llvmIrAllocaInstruction, allocatedType, nullptr, funcBoundInfo, layout))
+				continue;
+			FieldPath    path;
+			llvm::Type * compactType = getCompactType(allocatedType, path, layout, dataLayout);
+			uint64_t     size	 = dataLayout.getTypeAllocSize(allocatedType);
+			uint64_t     compactSize = dataLayout.getTypeAllocSize(compactType);
+			if (compactSize >= size)
+				continue;
+			flexprint(N->Fe, N->Fm, N->Fpinfo, "\tcompact data layout: %s of %s, %lu -> %lu bytes\n",
+				  llvmIrAllocaInstruction->getName().str().c_str(), llvmIrFunction.getName().str().c_str(), size, compactSize);
+
+			llvm::IRBuilder<>   Builder(llvmIrAllocaInstruction);
+			llvm::AllocaInst * compactAllocaInstruction = Builder.CreateAlloca(compactType);
+			compactAllocaInstruction->setAlignment(llvmIrAllocaInstruction->getAlign());
+			rewriteLayoutAccesses(llvmIrAllocaInstruction, compactAllocaInstruction, allocatedType, compactType, path,
+					      funcBoundInfo, layout);
+			moveValueRange(fbIt->second, llvmIrAllocaInstruction, {compactAllocaInstruction});
+			auto arIt = fbIt->second->arrayRange.find(llvmIrAllocaInstruction);
+			if (arIt != fbIt->second->arrayRange.end())
+				fbIt->second->arrayRange.erase(arIt);
+			compactAllocaInstruction->takeName(llvmIrAllocaInstruction);
+			/*
+			 * the debug information describes the old layout, so the variable is dropped from it
+			 * */
+			llvmIrAllocaInstruction->eraseFromParent();
+		}
+	}
+}
 	}
 
 
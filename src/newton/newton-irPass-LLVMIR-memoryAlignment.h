@@ -12,6 +12,11 @@ extern "C"
 void
 memoryAlignment(State * N, BoundInfo * boundInfo, llvm::Function & llvmIrFunction);
 
+void
+compactDataLayout(State * N, llvm::Module & llvmIrModule, BoundInfo * globalBoundInfo,
+		  std::map<std::string, BoundInfo *> & funcBoundInfo,
+		  std::map<llvm::Value *, std::vector<std::pair<double, double>>> & virtualRegisterVectorRange);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif /* __cplusplus */
@@ -41,6 +41,7 @@
 #include "newton-irPass-LLVMIR-constantSubstitution.h"
 #include "newton-irPass-LLVMIR-shrinkTypeByRange.h"
 #include "newton-irPass-LLVMIR-quantization.h"
+#include "newton-irPass-LLVMIR-precisionAnalysis.h"
 #include "newton-irPass-LLVMIR-memoryAlignment.h"
 #endif /* __cplusplus */
 
@@ -53,6 +54,7 @@
 #include <string.h>
 #include <set>
 
+#include "llvm/ADT/Hashing.h"
 #include "llvm/Bitcode/BitcodeWriter.h"
 #include "llvm/IR/DebugInfoMetadata.h"
 #include "llvm/IR/Metadata.h"
@@ -85,11 +87,13 @@ dumpIR(State * N, std::string fileSuffix, const std::unique_ptr<Module> & Mod)
 	dumpedFile.close();
 }
 
+/*
+ * the ranges of `src` (the global variables) are shared with `dst`, and only copied when `dst` changes them
+ * */
 void
 mergeBoundInfo(BoundInfo * dst, const BoundInfo * src)
 {
-	dst->virtualRegisterRange.insert(src->virtualRegisterRange.begin(),
-					 src->virtualRegisterRange.end());
+	dst->virtualRegisterRange.shareGlobalRanges(&src->virtualRegisterRange);
 	return;
 }
 
@@ -107,44 +111,18 @@ collectCalleeInfo(std::vector<std::string> &	       calleeNames,
 	return;
 }
 
-class FunctionNode {
-	mutable AssertingVH<Function>	 F;
-	FunctionComparator::FunctionHash Hash;
-
-	public:
-	// Note the hash is recalculated potentially multiple times, but it is cheap.
-	FunctionNode(Function * F)
-	    : F(F), Hash(FunctionComparator::functionHash(*F)) {}
-
-	Function *
-	getFunc() const
-	{
-		return F;
-	}
-
-	FunctionComparator::FunctionHash
-	getHash() const
-	{
-		return Hash;
-	}
-};
-
-GlobalNumberState GlobalNumbers;
-
-class FunctionNodeCmp {
-	public:
-	bool
-	operator()(const FunctionNode & LHS, const FunctionNode & RHS) const
+/*
+ * the summaries are only valid while the IR is unchanged
+ * */
+void
+freeCalleeSummary(CalleeSummaryMap & calleeSummary)
+{
+	for (auto & summary : calleeSummary)
 	{
-		// Order first by hashes, then full function comparison.
-		if (LHS.getHash() != RHS.getHash())
-			return LHS.getHash() < RHS.getHash();
-		FunctionComparator FCmp(LHS.getFunc(), RHS.getFunc(), &GlobalNumbers);
-		return FCmp.compare() == -1;
+		delete summary.second.boundInfo;
 	}
-};
-
-using hashFuncSet = std::set<FunctionNode, FunctionNodeCmp>;
+	calleeSummary.clear();
+}
 
 void
 cleanFunctionMap(const std::unique_ptr<Module> & Mod, std::map<std::string, CallInst *> & callerMap)
@@ -162,10 +140,11 @@ void
 overloadFunc(std::unique_ptr<Module> & Mod, std::map<std::string, CallInst *> & callerMap)
 {
 	/*
-	 * compare the functions and remove the redundant one
+	 * compare the functions and remove the redundant one.
+	 * The functions are bucketed by their hash, so a function is only compared with the ones in its bucket.
 	 * */
-	hashFuncSet baseFuncs;
-	auto	    baseFuncNum = baseFuncs.size();
+	std::unordered_multimap<FunctionComparator::FunctionHash, Function *> baseFuncs;
+	GlobalNumberState							  cmpGlobalNumbers;
 	for (auto itFunc = Mod->getFunctionList().rbegin(); itFunc != Mod->getFunctionList().rend(); itFunc++)
 	{
 		if (!itFunc->hasName() || itFunc->getName().empty())
@@ -175,27 +154,24 @@ overloadFunc(std::unique_ptr<Module> & Mod, std::map<std::string, CallInst *> &
 			continue;
 		if (itFunc->isDeclaration())
 			continue;
-		baseFuncs.emplace(FunctionNode(&(*itFunc)));
-		/*
-		 * find the function with the same implementation and change the callInst
-		 * */
-		if (baseFuncNum == baseFuncs.size())
+		FunctionComparator::FunctionHash funcHash   = FunctionComparator::functionHash(*itFunc);
+		auto				 bucket	    = baseFuncs.equal_range(funcHash);
+		auto				 sameImplIt = std::find_if(bucket.first, bucket.second,
+								   [&itFunc, &cmpGlobalNumbers](const std::pair<const FunctionComparator::FunctionHash, Function *> & baseFunc) {
+									   FunctionComparator FCmp(baseFunc.second, &(*itFunc), &cmpGlobalNumbers);
+									   return FCmp.compare() == 0;
+								   });
+		if (sameImplIt == bucket.second)
 		{
-			auto callerIt = callerMap.find(itFunc->getName().str());
-			assert(callerIt != callerMap.end());
-			auto		  currentCallerInst = callerIt->second;
-			auto		  currentFuncNode   = FunctionNode(&(*itFunc));
-			GlobalNumberState cmpGlobalNumbers;
-			auto		  sameImplIt = std::find_if(baseFuncs.begin(), baseFuncs.end(),
-								    [currentFuncNode, &cmpGlobalNumbers](const FunctionNode & func) {
-								    FunctionComparator FCmp(func.getFunc(), currentFuncNode.getFunc(), &cmpGlobalNumbers);
-								    return func.getHash() == currentFuncNode.getHash() && FCmp.compare() == 0;
-							    });
-			assert(sameImplIt != baseFuncs.end());
-			currentCallerInst->setCalledFunction(sameImplIt->getFunc());
+			baseFuncs.emplace(funcHash, &(*itFunc));
+			continue;
 		}
-		else
-			baseFuncNum = baseFuncs.size();
+		/*
+		 * find the function with the same implementation and change all of its callers,
+		 * as a specialized clone is called by every call in its context
+		 * */
+		assert(callerMap.find(itFunc->getName().str()) != callerMap.end());
+		itFunc->replaceAllUsesWith(sameImplIt->second);
 	}
 
     legacy::PassManager passManager;
@@ -203,6 +179,196 @@ overloadFunc(std::unique_ptr<Module> & Mod, std::map<std::string, CallInst *> &
     passManager.run(*Mod);
 }
 
+/*
+ * the content of a constant: its kind and type, the value of a number, the name of a global,
+ * and the operands of an expression or aggregate
+ * */
+hash_code
+getConstantFingerprint(const llvm::Constant * constant)
+{
+	hash_code fingerprint = hash_combine(constant->getValueID(), constant->getType());
+	if (auto constantInt = dyn_cast<ConstantInt>(constant))
+		return hash_combine(fingerprint, constantInt->getValue());
+	if (auto constantFP = dyn_cast<ConstantFP>(constant))
+		return hash_combine(fingerprint, constantFP->getValueAPF());
+	if (auto globalValue = dyn_cast<GlobalValue>(constant))
+		return hash_combine(fingerprint, globalValue->getName());
+	for (auto & operand : constant->operands())
+	{
+		fingerprint = hash_combine(fingerprint, getConstantFingerprint(cast<llvm::Constant>(operand.get())));
+	}
+	return fingerprint;
+}
+
+/*
+ * a fingerprint of the body of a function: the address, opcode, type, predicate and operands of each instruction.
+ * The ranges kept for a function are keyed by the address of its values, so the addresses are part of it,
+ * but an operand is hashed by its position in the function and a constant by its content:
+ * an instruction freed and another allocated at its address only keeps the fingerprint if it is the same.
+ * The types are uniqued in the context and live as long as it does, so they are hashed by address.
+ * */
+hash_code
+getFunctionFingerprint(Function & llvmIrFunction)
+{
+	std::map<const Value *, size_t> positions;
+	for (auto & llvmIrArgument : llvmIrFunction.args())
+		positions.emplace(&llvmIrArgument, positions.size());
+	for (auto & llvmIrBasicBlock : llvmIrFunction)
+	{
+		positions.emplace(&llvmIrBasicBlock, positions.size());
+		for (auto & llvmIrInstruction : llvmIrBasicBlock)
+			positions.emplace(&llvmIrInstruction, positions.size());
+	}
+
+	hash_code fingerprint = hash_value(llvmIrFunction.getFunctionType());
+	for (auto & llvmIrArgument : llvmIrFunction.args())
+		fingerprint = hash_combine(fingerprint, &llvmIrArgument);
+	for (auto & llvmIrBasicBlock : llvmIrFunction)
+	{
+		fingerprint = hash_combine(fingerprint, &llvmIrBasicBlock, llvmIrBasicBlock.size());
+		for (auto & llvmIrInstruction : llvmIrBasicBlock)
+		{
+			fingerprint = hash_combine(fingerprint, &llvmIrInstruction, llvmIrInstruction.getOpcode(),
+						   llvmIrInstruction.getType());
+			if (auto llvmIrCmpInstruction = dyn_cast<CmpInst>(&llvmIrInstruction))
+				fingerprint = hash_combine(fingerprint, llvmIrCmpInstruction->getPredicate());
+			for (auto & operand : llvmIrInstruction.operands())
+			{
+				auto positionIt = positions.find(operand.get());
+				if (positionIt != positions.end())
+					fingerprint = hash_combine(fingerprint, positionIt->second);
+				else if (auto constant = dyn_cast<llvm::Constant>(operand.get()))
+					fingerprint = hash_combine(fingerprint, getConstantFingerprint(constant));
+				else
+					fingerprint = hash_combine(fingerprint, operand->getValueID());
+			}
+		}
+	}
+	return fingerprint;
+}
+
+enum SpecializationLimit {
+	/*
+	 * in percent of the instructions of the module, the clones may double it
+	 * */
+	DefaultSpecializationBudget = 100,
+};
+
+/*
+ * Infer the ranges of the functions whose ranges are out of date, instead of the whole module.
+ * `analyzedFunctions` keeps the fingerprint and the `useOverLoad` of the functions analyzed on their own,
+ * a function is analyzed again if
+ * 1. its body changed since, e.g. by shrinkType() or simplifyControlFlow(),
+ * 2. its ranges were inferred in the context of a caller (the overloaded functions),
+ * 3. it calls a defined function and `useOverLoad` changed, as that decides if the callee is overloaded,
+ * 4. it calls a function that is analyzed again.
+ * */
+void
+updateRangeAnalysis(State * N, std::unique_ptr<Module> & Mod, const BoundInfo * globalBoundInfo,
+		    std::map<std::string, BoundInfo *> &			     funcBoundInfo,
+		    std::map<std::string, std::pair<hash_code, bool>> &		     analyzedFunctions,
+		    std::map<std::string, CallInst *> &				     callerMap,
+		    const std::map<std::string, std::pair<double, double>> &	     typeRange,
+		    const std::map<Value *, std::vector<std::pair<double, double>>> & virtualRegisterVectorRange,
+		    bool							     useOverLoad)
+{
+	/*
+	 * forget the functions removed by the transforms
+	 * */
+	for (auto fbIt = funcBoundInfo.begin(); fbIt != funcBoundInfo.end();)
+	{
+		if (nullptr == Mod->getFunction(fbIt->first))
+			fbIt = funcBoundInfo.erase(fbIt);
+		else
+			++fbIt;
+	}
+
+	std::set<Function *>			    staleFunctions;
+	std::map<Function *, std::set<Function *>> callers;
+	for (auto & mi : *Mod)
+	{
+		bool callsDefinedFunction = false;
+		for (Instruction & llvmIrInstruction : instructions(mi))
+		{
+			auto llvmIrCallInstruction = dyn_cast<CallInst>(&llvmIrInstruction);
+			if (llvmIrCallInstruction == nullptr)
+				continue;
+			Function * calledFunction = llvmIrCallInstruction->getCalledFunction();
+			if (calledFunction == nullptr || calledFunction->isDeclaration())
+				continue;
+			callers[calledFunction].emplace(&mi);
+			callsDefinedFunction = true;
+		}
+		auto afIt = analyzedFunctions.find(mi.getName().str());
+		if (afIt == analyzedFunctions.end() || afIt->second.first != getFunctionFingerprint(mi) ||
+		    (callsDefinedFunction && afIt->second.second != useOverLoad))
+		{
+			staleFunctions.emplace(&mi);
+		}
+	}
+	std::vector<Function *> staleCallees(staleFunctions.begin(), staleFunctions.end());
+	while (!staleCallees.empty())
+	{
+		Function * staleCallee = staleCallees.back();
+		staleCallees.pop_back();
+		for (Function * caller : callers[staleCallee])
+		{
+			if (staleFunctions.emplace(caller).second)
+				staleCallees.emplace_back(caller);
+		}
+	}
+	for (Function * staleFunction : staleFunctions)
+	{
+		funcBoundInfo.erase(staleFunction->getName().str());
+		analyzedFunctions.erase(staleFunction->getName().str());
+	}
+	flexprint(N->Fe, N->Fm, N->Fpinfo, "\tanalyze %zu of %zu functions\n", staleFunctions.size(), Mod->size());
+
+	/*
+	 * the overloaded callees are specialized for each context of their calls, within the size budget
+	 * */
+	CalleeSummaryMap calleeSummary;
+	uint64_t	 instructionNum = 0;
+	for (auto & mi : *Mod)
+	{
+		instructionNum += mi.getInstructionCount();
+	}
+	Specialization specialization{{}, {}, instructionNum * (N->llvmIRSpecializationBudget > 0 ? N->llvmIRSpecializationBudget
+											      : (uint64_t)DefaultSpecializationBudget) / 100};
+	for (auto & mi : *Mod)
+	{
+		/*
+		 * skip the functions whose ranges are up to date, and the ones analyzed in the context of a caller just now
+		 * */
+		if (staleFunctions.find(&mi) == staleFunctions.end() ||
+		    funcBoundInfo.find(mi.getName().str()) != funcBoundInfo.end())
+			continue;
+		auto boundInfo = new BoundInfo();
+		mergeBoundInfo(boundInfo, globalBoundInfo);
+		boundInfo->calleeSummary  = useOverLoad ? nullptr : &calleeSummary;
+		boundInfo->specialization = useOverLoad ? &specialization : nullptr;
+		rangeAnalysis(N, mi, boundInfo, callerMap, typeRange, virtualRegisterVectorRange, useOverLoad);
+		boundInfo->calleeSummary = nullptr;
+		funcBoundInfo.emplace(mi.getName().str(), boundInfo);
+		std::vector<std::string> calleeNames;
+		collectCalleeInfo(calleeNames, funcBoundInfo, boundInfo);
+		/*
+		 * overloading the callees changes the calls, so take the fingerprint after the analysis
+		 * */
+		analyzedFunctions[mi.getName().str()] = std::make_pair(getFunctionFingerprint(mi), useOverLoad);
+	}
+	freeCalleeSummary(calleeSummary);
+	for (auto & fbPair : funcBoundInfo)
+	{
+		fbPair.second->specialization = nullptr;
+	}
+	if (useOverLoad)
+	{
+		flexprint(N->Fe, N->Fm, N->Fpinfo, "\tspecialize %zu contexts, %lu instructions left in the budget\n",
+			  specialization.clones.size(), specialization.budget);
+	}
+}
+
 void
 irPassLLVMIROptimizeByRange(State * N)
 {
@@ -221,13 +387,15 @@ irPassLLVMIROptimizeByRange(State * N)
 		fatal(N, Esanity);
 	}
 
-	auto				   globalBoundInfo = new BoundInfo();
-	std::map<std::string, BoundInfo *> funcBoundInfo;
+	auto						  globalBoundInfo = new BoundInfo();
+	std::map<std::string, BoundInfo *>		  funcBoundInfo;
+	std::map<std::string, std::pair<hash_code, bool>> analyzedFunctions;
 
 	/*
-	 * get sensor info, we only concern the id and range here
+	 * get sensor info, we only concern the id, range and error here
 	 * */
 	std::map<std::string, std::pair<double, double>> typeRange;
+	std::map<std::string, double>			 typeError;
 	if (N->sensorList != NULL)
 	{
 		for (Modality * currentModality = N->sensorList->modalityList; currentModality != NULL; currentModality = currentModality->next)
@@ -236,6 +404,14 @@ irPassLLVMIROptimizeByRange(State * N)
 			flexprint(N->Fe, N->Fm, N->Fpinfo, "\t\trangeLowerBound: %f\n", currentModality->rangeLowerBound);
 			flexprint(N->Fe, N->Fm, N->Fpinfo, "\t\trangeUpperBound: %f\n", currentModality->rangeUpperBound);
 			typeRange.emplace(currentModality->identifier, std::make_pair(currentModality->rangeLowerBound, currentModality->rangeUpperBound));
+			/*
+			 * the error of a reading is its accuracy, or half of the resolution of its precision bits
+			 * */
+			double resolution = currentModality->precisionBits > 0
+						    ? (currentModality->rangeUpperBound - currentModality->rangeLowerBound) /
+							      std::ldexp(1.0, currentModality->precisionBits)
+						    : 0;
+			typeError.emplace(currentModality->identifier, max(std::fabs(currentModality->accuracy), resolution / 2));
 		}
 	}
 
@@ -317,17 +493,9 @@ irPassLLVMIROptimizeByRange(State * N)
 	flexprint(N->Fe, N->Fm, N->Fpinfo, "infer bound\n");
 	std::map<std::string, CallInst *> callerMap;
 	callerMap.clear();
-    funcBoundInfo.clear();
 	bool useOverLoad = false;
-	for (auto & mi : *Mod)
-	{
-		auto boundInfo = new BoundInfo();
-		mergeBoundInfo(boundInfo, globalBoundInfo);
-		rangeAnalysis(N, mi, boundInfo, callerMap, typeRange, virtualRegisterVectorRange, useOverLoad);
-		funcBoundInfo.emplace(mi.getName().str(), boundInfo);
-		std::vector<std::string> calleeNames;
-		collectCalleeInfo(calleeNames, funcBoundInfo, boundInfo);
-	}
+	updateRangeAnalysis(N, Mod, globalBoundInfo, funcBoundInfo, analyzedFunctions, callerMap,
+			    typeRange, virtualRegisterVectorRange, useOverLoad);
 
     flexprint(N->Fe, N->Fm, N->Fpinfo, "shrink data type by range\n");
     for (auto & mi : *Mod)
@@ -356,6 +524,9 @@ irPassLLVMIROptimizeByRange(State * N)
 //        }
     }
 
+	flexprint(N->Fe, N->Fm, N->Fpinfo, "compact data layout\n");
+	compactDataLayout(N, *Mod, globalBoundInfo, funcBoundInfo, virtualRegisterVectorRange);
+
     /*
 	 * remove the functions that are optimized by passes.
 	 * */
@@ -366,17 +537,9 @@ irPassLLVMIROptimizeByRange(State * N)
         overloadFunc(Mod, callerMap);
 
     callerMap.clear();
-    funcBoundInfo.clear();
     useOverLoad = true;
-    for (auto & mi : *Mod)
-    {
-        auto boundInfo = new BoundInfo();
-        mergeBoundInfo(boundInfo, globalBoundInfo);
-        rangeAnalysis(N, mi, boundInfo, callerMap, typeRange, virtualRegisterVectorRange, useOverLoad);
-        funcBoundInfo.emplace(mi.getName().str(), boundInfo);
-        std::vector<std::string> calleeNames;
-        collectCalleeInfo(calleeNames, funcBoundInfo, boundInfo);
-    }
+	updateRangeAnalysis(N, Mod, globalBoundInfo, funcBoundInfo, analyzedFunctions, callerMap,
+			    typeRange, virtualRegisterVectorRange, useOverLoad);
 
 	/*
 	 * simplify the condition of each branch
@@ -412,17 +575,9 @@ irPassLLVMIROptimizeByRange(State * N)
 
 	flexprint(N->Fe, N->Fm, N->Fpinfo, "infer bound\n");
     callerMap.clear();
-	funcBoundInfo.clear();
     useOverLoad = false;
-	for (auto & mi : *Mod)
-	{
-		auto boundInfo = new BoundInfo();
-		mergeBoundInfo(boundInfo, globalBoundInfo);
-		rangeAnalysis(N, mi, boundInfo, callerMap, typeRange, virtualRegisterVectorRange, useOverLoad);
-		funcBoundInfo.emplace(mi.getName().str(), boundInfo);
-		std::vector<std::string> calleeNames;
-		collectCalleeInfo(calleeNames, funcBoundInfo, boundInfo);
-	}
+	updateRangeAnalysis(N, Mod, globalBoundInfo, funcBoundInfo, analyzedFunctions, callerMap,
+			    typeRange, virtualRegisterVectorRange, useOverLoad);
 
 	flexprint(N->Fe, N->Fm, N->Fpinfo, "constant substitution\n");
 	for (auto & mi : *Mod)
@@ -447,6 +602,46 @@ irPassLLVMIROptimizeByRange(State * N)
     if (useOverLoad)
         overloadFunc(Mod, callerMap);
 
+	/*
+	 * choose the precision, and quantize the floating-point arithmetic,
+	 * with the ranges of the IR after constant substitution
+	 * */
+	if ((N->irPasses & kNewtonirPassLLVMIRAutoQuantization) || N->llvmIRErrorBudget > 0)
+	{
+		flexprint(N->Fe, N->Fm, N->Fpinfo, "infer bound\n");
+		callerMap.clear();
+		useOverLoad = false;
+		updateRangeAnalysis(N, Mod, globalBoundInfo, funcBoundInfo, analyzedFunctions, callerMap,
+				    typeRange, virtualRegisterVectorRange, useOverLoad);
+	}
+
+	if (N->llvmIRErrorBudget > 0)
+	{
+		flexprint(N->Fe, N->Fm, N->Fpinfo, "precision analysis\n");
+		for (auto & mi : *Mod)
+		{
+			auto boundInfoIt = funcBoundInfo.find(mi.getName().str());
+			if (boundInfoIt != funcBoundInfo.end())
+			{
+				precisionAnalysis(N, boundInfoIt->second, mi, typeError);
+				shrinkPrecision(N, boundInfoIt->second, mi);
+			}
+		}
+	}
+
+	if (N->irPasses & kNewtonirPassLLVMIRAutoQuantization)
+	{
+		flexprint(N->Fe, N->Fm, N->Fpinfo, "auto quantization\n");
+		for (auto & mi : *Mod)
+		{
+			auto boundInfoIt = funcBoundInfo.find(mi.getName().str());
+			if (boundInfoIt != funcBoundInfo.end())
+			{
+				irPassLLVMIRAutoQuantization(N, boundInfoIt->second, mi);
+			}
+		}
+	}
+
 	/*
 	 * Dump BC file to a file.
 	 * */
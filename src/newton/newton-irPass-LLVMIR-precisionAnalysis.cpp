@@ -0,0 +1,636 @@
+/*
+	Authored 2022. Pei Mu.
+	All rights reserved.
+	Redistribution and use in source and binary forms, with or without
+	modification, are permitted provided that the following conditions
+	are met:
+	*	Redistributions of source code must retain the above
+		copyright notice, this list of conditions and the following
+		disclaimer.
+	*	Redistributions in binary form must reproduce the above
+		copyright notice, this list of conditions and the following
+		disclaimer in the documentation and/or other materials
+		provided with the distribution.
+	*	Neither the name of the author nor the names of its
+		contributors may be used to endorse or promote products
+		derived from this software without specific prior written
+		permission.
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+	"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+	LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+	FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+	COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+	INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+	BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+	LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+	CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+	LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+	ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+	POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#include "newton-irPass-LLVMIR-precisionAnalysis.h"
+#include "newton-irPass-LLVMIR-quantization.h"
+
+using namespace llvm;
+
+extern "C"
+{
+enum PrecisionLimit {
+	/*
+	 * the significand bits of `float`, its rounding error is 2^-FloatSignificandBits of the value
+	 * */
+	FloatSignificandBits = 24,
+	/*
+	 * the error bounds of the values in loops grow to infinity after these iterations
+	 * */
+	MaxPrecisionIterations = 16,
+};
+
+/*
+ * the product of a magnitude and an error bound, 0 if there is no error even if the magnitude is unbounded
+ * */
+double
+scaleError(double magnitude, double error)
+{
+	return (magnitude == 0 || error == 0) ? 0 : magnitude * error;
+}
+
+/*
+ * the smallest and the largest magnitude of a value in its range, [0, inf] without a range
+ * */
+std::pair<double, double>
+getMagnitude(const BoundInfo * boundInfo, Value * value)
+{
+	std::pair<double, double> range;
+	if (auto constFp = dyn_cast<ConstantFP>(value))
+	{
+		range.first = range.second = constFp->getValueAPF().convertToDouble();
+	}
+	else
+	{
+		auto vrRangeIt = boundInfo->virtualRegisterRange.find(value);
+		if (vrRangeIt == boundInfo->virtualRegisterRange.end())
+		{
+			return std::make_pair(0.0, std::numeric_limits<double>::infinity());
+		}
+		range = vrRangeIt->second;
+	}
+	double maxMagnitude = max(std::fabs(range.first), std::fabs(range.second));
+	double minMagnitude = (range.first <= 0 && range.second >= 0) ? 0 : min(std::fabs(range.first), std::fabs(range.second));
+	return std::make_pair(minMagnitude, maxMagnitude);
+}
+
+/*
+ * the name of the sensor type of a variable, of the pointee for a pointer
+ * */
+std::string
+getSensorTypeName(const DIType * variableType)
+{
+	auto derivedType = dyn_cast_or_null<DIDerivedType>(variableType);
+	if (derivedType == nullptr)
+	{
+		return "";
+	}
+	if (derivedType->getTag() == dwarf::DW_TAG_pointer_type)
+	{
+		return derivedType->getBaseType() == nullptr ? "" : derivedType->getBaseType()->getName().str();
+	}
+	return derivedType->getName().str();
+}
+
+/*
+ * the users whose error is the error of the function: stores, returns, calls, comparisons and conversions to integers
+ * */
+bool
+isOutputUser(Instruction * llvmIrInstruction)
+{
+	if (isa<DbgInfoIntrinsic>(llvmIrInstruction))
+	{
+		return false;
+	}
+	if (auto llvmIrCallInstruction = dyn_cast<CallInst>(llvmIrInstruction))
+	{
+		Function * calledFunction = llvmIrCallInstruction->getCalledFunction();
+		return calledFunction == nullptr ||
+		       (calledFunction->getIntrinsicID() != Intrinsic::sqrt && calledFunction->getIntrinsicID() != Intrinsic::fabs);
+	}
+	switch (llvmIrInstruction->getOpcode())
+	{
+		case Instruction::Store:
+		case Instruction::Ret:
+		case Instruction::FCmp:
+		case Instruction::FPToSI:
+		case Instruction::FPToUI:
+			return true;
+		default:
+			return false;
+	}
+}
+
+/*
+ * how much an error of the operand `operandIndex` of an instruction grows in its result,
+ * i.e. the bound of the derivative in the ranges of the operands; infinity if it is not modeled
+ * */
+double
+getOperandSensitivity(const BoundInfo * boundInfo, Instruction * llvmIrInstruction, unsigned operandIndex)
+{
+	const double infinity = std::numeric_limits<double>::infinity();
+	switch (llvmIrInstruction->getOpcode())
+	{
+		case Instruction::FAdd:
+		case Instruction::FSub:
+		case Instruction::FNeg:
+		case Instruction::FPExt:
+		case Instruction::FPTrunc:
+		case Instruction::PHI:
+			return 1;
+		case Instruction::Select:
+			return operandIndex == 0 ? 0 : 1;
+		case Instruction::FMul:
+			return getMagnitude(boundInfo, llvmIrInstruction->getOperand(1 - operandIndex)).second;
+		case Instruction::FDiv:
+		{
+			/*
+			 * d(x/y)/dx = 1/y, d(x/y)/dy = -x/y^2
+			 * */
+			auto dividend = getMagnitude(boundInfo, llvmIrInstruction->getOperand(0));
+			auto divisor  = getMagnitude(boundInfo, llvmIrInstruction->getOperand(1));
+			if (operandIndex == 1 && dividend.second == 0)
+				return 0;
+			if (divisor.first == 0)
+				return infinity;
+			return operandIndex == 0 ? 1 / divisor.first : dividend.second / (divisor.first * divisor.first);
+		}
+		case Instruction::Call:
+		{
+			Function * calledFunction = cast<CallInst>(llvmIrInstruction)->getCalledFunction();
+			if (calledFunction != nullptr && calledFunction->getIntrinsicID() == Intrinsic::fabs)
+				return 1;
+			if (calledFunction != nullptr && calledFunction->getIntrinsicID() == Intrinsic::sqrt)
+			{
+				double minMagnitude = getMagnitude(boundInfo, llvmIrInstruction->getOperand(0)).first;
+				return minMagnitude > 0 ? 1 / (2 * std::sqrt(minMagnitude)) : infinity;
+			}
+			return infinity;
+		}
+		default:
+			return infinity;
+	}
+}
+
+/*
+ * the error bound of the result of an instruction from the error bounds of its operands,
+ * to the first order in the ranges of the operands; infinity if it is not modeled
+ * */
+double
+getResultError(const BoundInfo * boundInfo, Instruction * llvmIrInstruction, const std::function<double(Value *)> & getError)
+{
+	const double infinity = std::numeric_limits<double>::infinity();
+	switch (llvmIrInstruction->getOpcode())
+	{
+		case Instruction::FAdd:
+		case Instruction::FSub:
+			return getError(llvmIrInstruction->getOperand(0)) + getError(llvmIrInstruction->getOperand(1));
+		case Instruction::FNeg:
+		case Instruction::FPExt:
+			return getError(llvmIrInstruction->getOperand(0));
+		case Instruction::FPTrunc:
+		case Instruction::SIToFP:
+		case Instruction::UIToFP:
+		{
+			/*
+			 * the conversions round to the significand of the result, the integers it holds are exact
+			 * */
+			int    significandBits = llvmIrInstruction->getType()->getFPMantissaWidth();
+			double maxMagnitude    = getMagnitude(boundInfo, llvmIrInstruction).second;
+			double roundingError   = std::ldexp(maxMagnitude, -significandBits);
+			if (isa<FPTruncInst>(llvmIrInstruction))
+				return getError(llvmIrInstruction->getOperand(0)) + roundingError;
+			return maxMagnitude <= std::ldexp(1.0, significandBits) ? 0 : roundingError;
+		}
+		case Instruction::FMul:
+		{
+			Value * lhs	 = llvmIrInstruction->getOperand(0);
+			Value * rhs	 = llvmIrInstruction->getOperand(1);
+			double	lhsError = getError(lhs);
+			double	rhsError = getError(rhs);
+			return scaleError(getMagnitude(boundInfo, rhs).second, lhsError) +
+			       scaleError(getMagnitude(boundInfo, lhs).second, rhsError) + scaleError(lhsError, rhsError);
+		}
+		case Instruction::FDiv:
+		{
+			/*
+			 * |x/y - (x+a)/(y+b)| <= (|a||y| + |x||b|) / (|y| (|y| - |b|))
+			 * */
+			double dividendError = getError(llvmIrInstruction->getOperand(0));
+			double divisorError  = getError(llvmIrInstruction->getOperand(1));
+			if (dividendError == 0 && divisorError == 0)
+				return 0;
+			auto dividend = getMagnitude(boundInfo, llvmIrInstruction->getOperand(0));
+			auto divisor  = getMagnitude(boundInfo, llvmIrInstruction->getOperand(1));
+			if (divisor.first <= divisorError)
+				return infinity;
+			return (scaleError(divisor.first, dividendError) + scaleError(dividend.second, divisorError)) /
+			       (divisor.first * (divisor.first - divisorError));
+		}
+		case Instruction::PHI:
+		{
+			double error = 0;
+			for (Value * incomingValue : cast<PHINode>(llvmIrInstruction)->incoming_values())
+				error = max(error, getError(incomingValue));
+			return error;
+		}
+		case Instruction::Select:
+			return max(getError(llvmIrInstruction->getOperand(1)), getError(llvmIrInstruction->getOperand(2)));
+		case Instruction::Load:
+			return 0;
+		default:
+		{
+			Function * calledFunction = isa<CallInst>(llvmIrInstruction) ? cast<CallInst>(llvmIrInstruction)->getCalledFunction() : nullptr;
+			if (calledFunction != nullptr && calledFunction->getIntrinsicID() == Intrinsic::fabs)
+				return getError(llvmIrInstruction->getOperand(0));
+			if (calledFunction != nullptr && calledFunction->getIntrinsicID() == Intrinsic::sqrt)
+			{
+				double error	    = getError(llvmIrInstruction->getOperand(0));
+				double minMagnitude = getMagnitude(boundInfo, llvmIrInstruction->getOperand(0)).first;
+				if (error == 0)
+					return 0;
+				return minMagnitude > 0 ? error / (2 * std::sqrt(minMagnitude)) : std::sqrt(error);
+			}
+			/*
+			 * an instruction that is not modeled is exact only if its operands are
+			 * */
+			for (Value * operand : llvmIrInstruction->operands())
+			{
+				if (operand->getType()->isFloatingPointTy() && getError(operand) > 0)
+					return infinity;
+			}
+			return 0;
+		}
+	}
+}
+
+/*
+ * raise the bound of each value to the result of `transfer` until none changes;
+ * a bound that still grows after `MaxPrecisionIterations` iterations, e.g. an accumulator, becomes infinity
+ * */
+void
+solveBounds(const std::vector<Value *> & values, std::map<Value *, double> & bounds,
+	    const std::function<double(Value *)> & transfer)
+{
+	for (int iteration = 0;; iteration++)
+	{
+		bool isChanged = false;
+		for (Value * value : values)
+		{
+			double	 bound	     = transfer(value);
+			double & boundValue = bounds[value];
+			if (std::isnan(bound))
+				bound = std::numeric_limits<double>::infinity();
+			if (bound > boundValue)
+			{
+				boundValue = iteration < MaxPrecisionIterations ? bound : std::numeric_limits<double>::infinity();
+				isChanged  = true;
+			}
+		}
+		if (!isChanged)
+			break;
+	}
+}
+
+/*
+ * Choose the cheapest representation of each floating-point value that keeps the outputs of a function
+ * within the error budget `N->llvmIRErrorBudget`:
+ * 1. the values of the sensor types carry the error of their modality, i.e. its accuracy or the resolution
+ *    of its precision bits (`typeError`), which is propagated forward through the arithmetic with the ranges.
+ * 2. the sensitivity of the outputs (stores, returns, calls, comparisons) to each value is propagated backward.
+ * 3. the budget left by the sensor error is split evenly over the values, scaled by their sensitivities,
+ *    and each value gets the cheapest of Q format (if the auto quantization runs), `float` and its own type
+ *    whose rounding error fits its share.
+ * The choices are kept in `boundInfo->valuePrecision`, for `shrinkPrecision` and the auto quantization.
+ * */
+void
+precisionAnalysis(State * N, BoundInfo * boundInfo, llvm::Function & llvmIrFunction,
+		  const std::map<std::string, double> & typeError)
+{
+	flexprint(N->Fe, N->Fm, N->Fpinfo, "\tprecision analysis: %s\n", llvmIrFunction.getName().str().c_str());
+	if (llvmIrFunction.isDeclaration())
+	{
+		return;
+	}
+	const double infinity = std::numeric_limits<double>::infinity();
+
+	/*
+	 * the analyzed values: the `float` and `double` arguments and instructions, in reverse post-order
+	 * */
+	auto isAnalyzed = [](Value * value) {
+		return value->getType()->isFloatTy() || value->getType()->isDoubleTy();
+	};
+	std::vector<Value *> values;
+	for (Argument & llvmIrArgument : llvmIrFunction.args())
+	{
+		if (isAnalyzed(&llvmIrArgument))
+			values.emplace_back(&llvmIrArgument);
+	}
+	ReversePostOrderTraversal<Function *> rpoTraversal(&llvmIrFunction);
+	for (BasicBlock * llvmIrBasicBlock : rpoTraversal)
+	{
+		for (Instruction & llvmIrInstruction : *llvmIrBasicBlock)
+		{
+			if (isAnalyzed(&llvmIrInstruction))
+				values.emplace_back(&llvmIrInstruction);
+		}
+	}
+	if (values.empty())
+	{
+		return;
+	}
+
+	/*
+	 * 1. the error of the sensor values, and of the loads from the variables of sensor types
+	 * */
+	std::map<Value *, double> sensorError;
+	std::map<Value *, double> sensorAddressError;
+	for (BasicBlock & llvmIrBasicBlock : llvmIrFunction)
+	{
+		for (Instruction & llvmIrInstruction : llvmIrBasicBlock)
+		{
+			auto debugInfoIntrinsic = dyn_cast<DbgVariableIntrinsic>(&llvmIrInstruction);
+			if (debugInfoIntrinsic == nullptr || debugInfoIntrinsic->getVariableLocationOp(0) == nullptr)
+				continue;
+			auto typeErrorIt = typeError.find(getSensorTypeName(debugInfoIntrinsic->getVariable()->getType()));
+			if (typeErrorIt == typeError.end())
+				continue;
+			Value * variable = debugInfoIntrinsic->getVariableLocationOp(0);
+			if (isa<DbgDeclareInst>(debugInfoIntrinsic) || variable->getType()->isPointerTy())
+				sensorAddressError.emplace(variable, typeErrorIt->second);
+			else
+				sensorError.emplace(variable, typeErrorIt->second);
+		}
+	}
+	for (BasicBlock & llvmIrBasicBlock : llvmIrFunction)
+	{
+		for (Instruction & llvmIrInstruction : llvmIrBasicBlock)
+		{
+			/*
+			 * the argument stored to the variable of a sensor type
+			 * */
+			auto llvmIrStoreInstruction = dyn_cast<StoreInst>(&llvmIrInstruction);
+			if (llvmIrStoreInstruction == nullptr || !isa<Argument>(llvmIrStoreInstruction->getValueOperand()))
+				continue;
+			auto seIt = sensorAddressError.find(llvmIrStoreInstruction->getPointerOperand()->stripPointerCasts());
+			if (seIt != sensorAddressError.end())
+				sensorError.emplace(llvmIrStoreInstruction->getValueOperand(), seIt->second);
+		}
+	}
+
+	std::map<Value *, double> inputError;
+	auto getError = [&](Value * value) -> double {
+		if (isa<llvm::Constant>(value))
+			return 0;
+		auto ieIt = inputError.find(value);
+		return ieIt == inputError.end() ? 0 : ieIt->second;
+	};
+	solveBounds(values, inputError, [&](Value * value) -> double {
+		double error = 0;
+		if (auto llvmIrLoadInstruction = dyn_cast<LoadInst>(value))
+		{
+			auto seIt = sensorAddressError.find(llvmIrLoadInstruction->getPointerOperand()->stripPointerCasts());
+			if (seIt != sensorAddressError.end())
+				error = seIt->second;
+		}
+		else if (auto llvmIrInstruction = dyn_cast<Instruction>(value))
+		{
+			error = getResultError(boundInfo, llvmIrInstruction, getError);
+		}
+		auto seIt = sensorError.find(value);
+		return seIt == sensorError.end() ? error : max(error, seIt->second);
+	});
+
+	/*
+	 * 2. the sensitivity of the outputs to each value, from the users to the definitions
+	 * */
+	std::map<Value *, double> sensitivity;
+	std::vector<Value *>	  reversedValues(values.rbegin(), values.rend());
+	solveBounds(reversedValues, sensitivity, [&](Value * value) -> double {
+		double valueSensitivity = 0;
+		for (Use & use : value->uses())
+		{
+			auto user = dyn_cast<Instruction>(use.getUser());
+			if (user == nullptr)
+				return infinity;
+			double userSensitivity = 1;
+			if (!isOutputUser(user))
+			{
+				auto sIt	= sensitivity.find(user);
+				userSensitivity = scaleError(getOperandSensitivity(boundInfo, user, use.getOperandNo()),
+							     sIt == sensitivity.end() ? 0 : sIt->second);
+			}
+			valueSensitivity = max(valueSensitivity, userSensitivity);
+		}
+		return valueSensitivity;
+	});
+
+	/*
+	 * 3. the error the outputs already carry from the sensors, and the share of the rest per value
+	 * */
+	double outputError = 0;
+	for (BasicBlock & llvmIrBasicBlock : llvmIrFunction)
+	{
+		for (Instruction & llvmIrInstruction : llvmIrBasicBlock)
+		{
+			if (!isOutputUser(&llvmIrInstruction))
+				continue;
+			for (Value * operand : llvmIrInstruction.operands())
+			{
+				if (operand->getType()->isFloatingPointTy())
+					outputError = max(outputError, getError(operand));
+			}
+		}
+	}
+	double remainingError = N->llvmIRErrorBudget - outputError;
+	if (remainingError <= 0)
+	{
+		flexprint(N->Fe, N->Fm, N->Fpinfo, "\tprecision analysis: the sensor error %g reaches the error budget %g\n",
+			  outputError, N->llvmIRErrorBudget);
+	}
+
+	bool   hasFixedPoint	= N->irPasses & kNewtonirPassLLVMIRAutoQuantization;
+	size_t formatCounts[3]	= {0, 0, 0};
+	for (Value * value : values)
+	{
+		ValuePrecision precision;
+		double	       valueSensitivity = sensitivity[value];
+		precision.format		= value->getType()->isFloatTy() ? kPrecisionFloat : kPrecisionDouble;
+		precision.inputError		= getError(value);
+		if (remainingError <= 0 || valueSensitivity == infinity)
+			precision.roundingError = 0;
+		else if (valueSensitivity == 0)
+			precision.roundingError = infinity;
+		else
+			precision.roundingError = remainingError / (values.size() * valueSensitivity);
+
+		auto vrRangeIt = boundInfo->virtualRegisterRange.find(value);
+		if (vrRangeIt != boundInfo->virtualRegisterRange.end() && precision.roundingError > 0)
+		{
+			int fractionBits = getFractionBits(vrRangeIt->second);
+			/*
+			 * rounding to `float` also rounds the constant operands of the instruction
+			 * */
+			double floatError = std::ldexp(getMagnitude(boundInfo, value).second, -FloatSignificandBits);
+			if (auto llvmIrInstruction = dyn_cast<Instruction>(value))
+			{
+				for (unsigned operandIndex = 0; operandIndex < llvmIrInstruction->getNumOperands(); operandIndex++)
+				{
+					auto constFp = dyn_cast<ConstantFP>(llvmIrInstruction->getOperand(operandIndex));
+					if (constFp == nullptr)
+						continue;
+					double constValue = constFp->getValueAPF().convertToDouble();
+					if (static_cast<double>(static_cast<float>(constValue)) != constValue)
+						floatError += scaleError(getOperandSensitivity(boundInfo, llvmIrInstruction, operandIndex),
+									 std::ldexp(std::fabs(constValue), -FloatSignificandBits));
+				}
+			}
+			if (hasFixedPoint && fractionBits >= 0 && std::ldexp(1.0, -fractionBits) <= precision.roundingError)
+				precision.format = kPrecisionFixedPoint;
+			else if (floatError <= precision.roundingError)
+				precision.format = min(precision.format, kPrecisionFloat);
+		}
+		boundInfo->valuePrecision[value] = precision;
+		formatCounts[precision.format]++;
+	}
+	flexprint(N->Fe, N->Fm, N->Fpinfo, "\tprecision analysis: %zu fixed-point, %zu float, %zu double values\n",
+		  formatCounts[kPrecisionFixedPoint], formatCounts[kPrecisionFloat], formatCounts[kPrecisionDouble]);
+}
+
+/*
+ * Rewrite the `double` arithmetic whose values the precision analysis allows in `float`:
+ * the operands are truncated, or taken before their extension if they are already `float`,
+ * and the result is extended back, so a chain of operations stays in `float`.
+ * */
+void
+shrinkPrecision(State * N, BoundInfo * boundInfo, llvm::Function & llvmIrFunction)
+{
+	if (llvmIrFunction.isDeclaration() || boundInfo->valuePrecision.empty())
+	{
+		return;
+	}
+	Type * floatType = Type::getFloatTy(llvmIrFunction.getContext());
+	auto   isShrunk	 = [&](Value * value) {
+		    if (isa<ConstantFP>(value))
+			    return true;
+		    auto vpIt = boundInfo->valuePrecision.find(value);
+		    return vpIt != boundInfo->valuePrecision.end() && vpIt->second.format == kPrecisionFloat;
+	};
+
+	std::vector<Instruction *>		  shrunkInstructions;
+	ReversePostOrderTraversal<Function *> rpoTraversal(&llvmIrFunction);
+	for (BasicBlock * llvmIrBasicBlock : rpoTraversal)
+	{
+		for (Instruction & llvmIrInstruction : *llvmIrBasicBlock)
+		{
+			switch (llvmIrInstruction.getOpcode())
+			{
+				case Instruction::FAdd:
+				case Instruction::FSub:
+				case Instruction::FMul:
+				case Instruction::FDiv:
+				case Instruction::FNeg:
+				{
+					if (!llvmIrInstruction.getType()->isDoubleTy() || !isShrunk(&llvmIrInstruction))
+						break;
+					if (std::all_of(llvmIrInstruction.op_begin(), llvmIrInstruction.op_end(),
+							[&](Value * operand) { return isShrunk(operand); }))
+						shrunkInstructions.emplace_back(&llvmIrInstruction);
+					break;
+				}
+				default:
+					break;
+			}
+		}
+	}
+	if (shrunkInstructions.empty())
+	{
+		return;
+	}
+	flexprint(N->Fe, N->Fm, N->Fpinfo, "\tshrink precision: %zu instructions to float\n", shrunkInstructions.size());
+
+	/*
+	 * the `float` value of an operand, a `double` value is truncated once right after its definition
+	 * */
+	std::map<Value *, Value *> truncatedValues;
+	auto			   getFloatOperand = [&](Value * operand) -> Value * {
+		  if (auto constFp = dyn_cast<ConstantFP>(operand))
+			  return ConstantFP::get(floatType, constFp->getValueAPF().convertToDouble());
+		  if (auto llvmIrExtension = dyn_cast<FPExtInst>(operand))
+		  {
+			  if (llvmIrExtension->getOperand(0)->getType()->isFloatTy())
+				  return llvmIrExtension->getOperand(0);
+		  }
+		  auto tvIt = truncatedValues.find(operand);
+		  if (tvIt != truncatedValues.end())
+			  return tvIt->second;
+		  Instruction * insertPoint = &*llvmIrFunction.getEntryBlock().getFirstInsertionPt();
+		  if (auto llvmIrInstruction = dyn_cast<Instruction>(operand))
+			  insertPoint = isa<PHINode>(llvmIrInstruction) ? llvmIrInstruction->getParent()->getFirstNonPHI()
+									: llvmIrInstruction->getNextNode();
+		  IRBuilder<> Builder(insertPoint);
+		  Value *     truncatedValue = Builder.CreateFPTrunc(operand, floatType);
+		  auto	      vrRangeIt	     = boundInfo->virtualRegisterRange.find(operand);
+		  if (vrRangeIt != boundInfo->virtualRegisterRange.end())
+			  boundInfo->virtualRegisterRange.emplace(truncatedValue, vrRangeIt->second);
+		  truncatedValues.emplace(operand, truncatedValue);
+		  return truncatedValue;
+	};
+
+	std::vector<Instruction *> extensions;
+	for (Instruction * llvmIrInstruction : shrunkInstructions)
+	{
+		IRBuilder<> Builder(llvmIrInstruction);
+		Value *	    floatValue;
+		if (llvmIrInstruction->getOpcode() == Instruction::FNeg)
+			floatValue = Builder.CreateFNeg(getFloatOperand(llvmIrInstruction->getOperand(0)));
+		else
+			floatValue = Builder.CreateBinOp(static_cast<Instruction::BinaryOps>(llvmIrInstruction->getOpcode()),
+							 getFloatOperand(llvmIrInstruction->getOperand(0)),
+							 getFloatOperand(llvmIrInstruction->getOperand(1)));
+		if (auto floatInstruction = dyn_cast<Instruction>(floatValue))
+			floatInstruction->copyIRFlags(llvmIrInstruction);
+		Value * extendedValue = Builder.CreateFPExt(floatValue, llvmIrInstruction->getType());
+		if (auto llvmIrExtension = dyn_cast<Instruction>(extendedValue))
+			extensions.emplace_back(llvmIrExtension);
+
+		/*
+		 * the new values take the range and the precision of the instruction, which is removed from the maps
+		 * */
+		auto vrRangeIt = boundInfo->virtualRegisterRange.find(llvmIrInstruction);
+		if (vrRangeIt != boundInfo->virtualRegisterRange.end())
+		{
+			boundInfo->virtualRegisterRange.emplace(floatValue, vrRangeIt->second);
+			boundInfo->virtualRegisterRange.emplace(extendedValue, vrRangeIt->second);
+			boundInfo->virtualRegisterRange.erase(vrRangeIt);
+		}
+		auto vpIt = boundInfo->valuePrecision.find(llvmIrInstruction);
+		boundInfo->valuePrecision.emplace(floatValue, vpIt->second);
+		boundInfo->valuePrecision.emplace(extendedValue, vpIt->second);
+		boundInfo->valuePrecision.erase(vpIt);
+
+		llvmIrInstruction->replaceAllUsesWith(extendedValue);
+		llvmIrInstruction->eraseFromParent();
+	}
+
+	/*
+	 * the extensions only used by shrunk instructions are dead
+	 * */
+	for (Instruction * llvmIrExtension : extensions)
+	{
+		if (!llvmIrExtension->use_empty())
+			continue;
+		boundInfo->virtualRegisterRange.erase(llvmIrExtension);
+		boundInfo->valuePrecision.erase(llvmIrExtension);
+		llvmIrExtension->eraseFromParent();
+	}
+}
+}
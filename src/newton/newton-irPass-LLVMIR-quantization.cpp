@@ -29,108 +29,449 @@
 	POSSIBILITY OF SUCH DAMAGE.
 */
 
+
 #include "newton-irPass-LLVMIR-quantization.h"
 
 using namespace llvm;
 
 extern "C"
 {
+/*
+ * the Q format of the quantized values: a signed 32-bit integer with a number of fraction bits
+ * chosen per value from its range, so the values with smaller ranges keep more precision.
+ * */
+enum FixedPointFormat {
+	FixedPointBits	= 32,
+	/*
+	 * a value whose range leaves fewer fraction bits stays in floating point
+	 * */
+	MinFractionBits = 8,
+	MaxFractionBits = FixedPointBits - 2,
+	/*
+	 * the shift of the dividend of a division, which is done in 64 bits
+	 * */
+	MaxDivisionShift = 64 - FixedPointBits,
+};
+
+/*
+ * the fraction bits of the values in `range`, -1 if they don't fit with `MinFractionBits`
+ * */
+int
+getFractionBits(const std::pair<double, double> & range)
+{
+	double maxAbsolute = max(std::fabs(range.first), std::fabs(range.second));
+	if (!std::isfinite(maxAbsolute))
+	{
+		return -1;
+	}
+	/*
+	 * one bit for the sign, and the bits of the integer part
+	 * */
+	int integerBits	 = maxAbsolute < 1 ? 0 : static_cast<int>(std::floor(std::log2(maxAbsolute))) + 1;
+	int fractionBits = min(static_cast<int>(MaxFractionBits), FixedPointBits - 1 - integerBits);
+	return fractionBits < MinFractionBits ? -1 : fractionBits;
+}
+
+/*
+ * the Q format of an operand: constants are exact, the other values need a range
+ * */
+int
+getOperandFractionBits(const BoundInfo * boundInfo, Value * operand)
+{
+	if (auto constFp = dyn_cast<ConstantFP>(operand))
+	{
+		double constValue = constFp->getValueAPF().convertToDouble();
+		return getFractionBits(std::make_pair(constValue, constValue));
+	}
+	auto vrRangeIt = boundInfo->virtualRegisterRange.find(operand);
+	if (vrRangeIt == boundInfo->virtualRegisterRange.end())
+	{
+		return -1;
+	}
+	return getFractionBits(vrRangeIt->second);
+}
+
+/*
+ * the integer comparison in Q format of an ordered or unordered floating-point comparison,
+ * NaN is not modeled like in the range analysis
+ * */
+CmpInst::Predicate
+getFixedPointPredicate(CmpInst::Predicate predicate)
+{
+	switch (predicate)
+	{
+		case CmpInst::FCMP_OEQ:
+		case CmpInst::FCMP_UEQ:
+			return CmpInst::ICMP_EQ;
+		case CmpInst::FCMP_ONE:
+		case CmpInst::FCMP_UNE:
+			return CmpInst::ICMP_NE;
+		case CmpInst::FCMP_OGT:
+		case CmpInst::FCMP_UGT:
+			return CmpInst::ICMP_SGT;
+		case CmpInst::FCMP_OGE:
+		case CmpInst::FCMP_UGE:
+			return CmpInst::ICMP_SGE;
+		case CmpInst::FCMP_OLT:
+		case CmpInst::FCMP_ULT:
+			return CmpInst::ICMP_SLT;
+		case CmpInst::FCMP_OLE:
+		case CmpInst::FCMP_ULE:
+			return CmpInst::ICMP_SLE;
+		default:
+			return CmpInst::BAD_ICMP_PREDICATE;
+	}
+}
+
+/*
+ * Rewrite the floating-point arithmetic of a function into Q-format integer arithmetic:
+ * 1. a scalar floating-point instruction is quantized if its range and the ranges of its operands
+ *    leave at least `MinFractionBits` fraction bits, each value gets the fraction bits of its own range.
+ * 2. the operands are shifted to the format an operation needs: additions and comparisons align
+ *    both sides, multiplications and divisions are done in 64 bits and shifted back.
+ * 3. a value that is not quantized, e.g. an argument, a load, or the result of a call, is converted
+ *    once after it is defined, saturating to its range (`llvm.fptosi.sat`).
+ * 4. a quantized value used by an instruction that is not quantized, e.g. a store, a call, or the return,
+ *    is converted back to floating point once after it is defined.
+ * The quantized floating-point instructions are removed, and the interface of the function is unchanged.
+ * */
 void
 irPassLLVMIRAutoQuantization(State * N, BoundInfo * boundInfo, llvm::Function & llvmIrFunction)
 {
-    flexprint(N->Fe, N->Fm, N->Fpinfo, "\tauto quantization.\n");
+	flexprint(N->Fe, N->Fm, N->Fpinfo, "\tauto quantization: %s\n", llvmIrFunction.getName().str().c_str());
+	if (llvmIrFunction.isDeclaration())
+	{
+		return;
+	}
+	LLVMContext & context	    = llvmIrFunction.getContext();
+	Type *	      fixedType	    = Type::getIntNTy(context, FixedPointBits);
+	Type *	      productType   = Type::getIntNTy(context, 2 * FixedPointBits);
+	Module *      llvmIrModule  = llvmIrFunction.getParent();
+
 	/*
-	 * Some special instructions that need to pay attention:
-	 * %i = alloca type, the type of this instruction is "type*"
-	 * %i = call retType @func_name (type %p1, ...)
-	 * call void @llvm.dbg.declare/value (metadata type %p, ...)
-	 * %i = load type, type* %op, the type of this instruction is "type"
-	 * %i = gep type, type1* %op1, type2 %op2, (type3 %op3)
-	 * %i = castInst type1 %op1 to type2
-	 * store type %op1, type* %op2
-	 * %.i = phi type [%op1, %bb1], [%op2, %bb2], ...
-	 * %i = binary type %op1, %op2
-	 * %i = unary type %op
+	 * 1. the quantized instructions and their fraction bits, in reverse post-order
+	 *    so that an operand is quantized before its users, except for the incoming values of PHIs
 	 * */
-	for (BasicBlock & llvmIrBasicBlock : llvmIrFunction)
+	std::vector<Instruction *>  quantizedInstructions;
+	std::map<Value *, int>	    fractionBits;
+	ReversePostOrderTraversal<Function *> rpoTraversal(&llvmIrFunction);
+	for (BasicBlock * llvmIrBasicBlock : rpoTraversal)
 	{
-		for (BasicBlock::iterator itBB = llvmIrBasicBlock.begin(); itBB != llvmIrBasicBlock.end();)
+		for (Instruction & llvmIrInstruction : *llvmIrBasicBlock)
 		{
-			Instruction * llvmIrInstruction = &*itBB++;
-			switch (llvmIrInstruction->getOpcode())
+			bool isQuantized = false;
+			switch (llvmIrInstruction.getOpcode())
 			{
-				case Instruction::Call:
-				case Instruction::Add:
 				case Instruction::FAdd:
-				case Instruction::Sub:
 				case Instruction::FSub:
-				case Instruction::Mul:
 				case Instruction::FMul:
-				case Instruction::SDiv:
-				case Instruction::FDiv:
-				case Instruction::UDiv:
-				case Instruction::URem:
-				case Instruction::SRem:
-				case Instruction::FRem:
-				case Instruction::Shl:
-				case Instruction::LShr:
-				case Instruction::AShr:
-				case Instruction::And:
-				case Instruction::Or:
-				case Instruction::Xor:
 				case Instruction::FNeg:
-				case Instruction::FPToUI:
-				case Instruction::FPToSI:
-				case Instruction::SIToFP:
-				case Instruction::UIToFP:
-				case Instruction::ZExt:
-				case Instruction::SExt:
 				case Instruction::FPExt:
-				case Instruction::Trunc:
 				case Instruction::FPTrunc:
-				case Instruction::BitCast:
-				case Instruction::Load:
-				case Instruction::GetElementPtr:
 				case Instruction::PHI:
-				case Instruction::Store:
-				case Instruction::ICmp:
-				case Instruction::FCmp:
-				case Instruction::Ret:
-				case Instruction::Switch:
-				case Instruction::Br:
 				case Instruction::Select:
-				case Instruction::IndirectBr:
-				case Instruction::Invoke:
-				case Instruction::Resume:
-				case Instruction::Unreachable:
-				case Instruction::CleanupRet:
-				case Instruction::CatchRet:
-				case Instruction::CatchSwitch:
-				case Instruction::CallBr:
-				case Instruction::Fence:
-				case Instruction::AtomicCmpXchg:
-				case Instruction::AtomicRMW:
-				case Instruction::PtrToInt:
-				case Instruction::IntToPtr:
-				case Instruction::AddrSpaceCast:
-				case Instruction::CleanupPad:
-				case Instruction::CatchPad:
-				case Instruction::UserOp1:
-				case Instruction::UserOp2:
-				case Instruction::VAArg:
-				case Instruction::ExtractElement:
-				case Instruction::InsertElement:
-				case Instruction::ShuffleVector:
-				case Instruction::ExtractValue:
-				case Instruction::InsertValue:
-				case Instruction::LandingPad:
-				case Instruction::Freeze:
+				{
+					if (!llvmIrInstruction.getType()->isFloatingPointTy() ||
+					    getOperandFractionBits(boundInfo, &llvmIrInstruction) < 0)
+						break;
+					isQuantized = true;
+					for (Value * operand : llvmIrInstruction.operands())
+					{
+						if (operand->getType()->isFloatingPointTy() && getOperandFractionBits(boundInfo, operand) < 0)
+							isQuantized = false;
+					}
+					break;
+				}
+				case Instruction::FDiv:
+				{
+					int resultBits	 = getOperandFractionBits(boundInfo, &llvmIrInstruction);
+					int dividendBits = getOperandFractionBits(boundInfo, llvmIrInstruction.getOperand(0));
+					int divisorBits	 = getOperandFractionBits(boundInfo, llvmIrInstruction.getOperand(1));
+					if (!llvmIrInstruction.getType()->isFloatingPointTy() || resultBits < 0 || dividendBits < 0 ||
+					    divisorBits < 0)
+						break;
+					/*
+					 * the divisor must not be 0 in Q format, so no value in its range is below its least significant bit,
+					 * and the dividend is shifted by at most `MaxDivisionShift` in 64 bits
+					 * */
+					std::pair<double, double> divisorRange;
+					if (auto constFp = dyn_cast<ConstantFP>(llvmIrInstruction.getOperand(1)))
+					{
+						divisorRange.first = divisorRange.second = constFp->getValueAPF().convertToDouble();
+					}
+					else
+					{
+						divisorRange = boundInfo->virtualRegisterRange.find(llvmIrInstruction.getOperand(1))->second;
+					}
+					int dividendShift = resultBits - dividendBits + divisorBits;
+					isQuantized	  = (divisorRange.first > 0 || divisorRange.second < 0) &&
+						      min(std::fabs(divisorRange.first), std::fabs(divisorRange.second)) >= std::ldexp(1.0, -divisorBits) &&
+						      dividendShift >= 0 && dividendShift <= MaxDivisionShift;
+					break;
+				}
+				case Instruction::SIToFP:
+				case Instruction::UIToFP:
+					isQuantized = llvmIrInstruction.getType()->isFloatingPointTy() &&
+						      getOperandFractionBits(boundInfo, &llvmIrInstruction) >= 0;
+					break;
+				case Instruction::FPToSI:
+				case Instruction::FPToUI:
+					isQuantized = llvmIrInstruction.getOperand(0)->getType()->isFloatingPointTy() &&
+						      fractionBits.find(llvmIrInstruction.getOperand(0)) != fractionBits.end();
 					break;
+				case Instruction::FCmp:
+				{
+					/*
+					 * a comparison is worth it if one side is already quantized
+					 * */
+					Value * lhs = llvmIrInstruction.getOperand(0);
+					Value * rhs = llvmIrInstruction.getOperand(1);
+					isQuantized = lhs->getType()->isFloatingPointTy() &&
+						      getFixedPointPredicate(cast<FCmpInst>(llvmIrInstruction).getPredicate()) != CmpInst::BAD_ICMP_PREDICATE &&
+						      (fractionBits.find(lhs) != fractionBits.end() || fractionBits.find(rhs) != fractionBits.end()) &&
+						      getOperandFractionBits(boundInfo, lhs) >= 0 && getOperandFractionBits(boundInfo, rhs) >= 0;
+					break;
+				}
 				default:
 					break;
 			}
+			/*
+			 * with an error budget, only the values the precision analysis allows in Q format
+			 * */
+			auto vpIt = boundInfo->valuePrecision.find(&llvmIrInstruction);
+			if (vpIt != boundInfo->valuePrecision.end() && vpIt->second.format != kPrecisionFixedPoint)
+			{
+				isQuantized = false;
+			}
+			if (isQuantized)
+			{
+				quantizedInstructions.emplace_back(&llvmIrInstruction);
+				if (llvmIrInstruction.getType()->isFloatingPointTy())
+					fractionBits.emplace(&llvmIrInstruction, getOperandFractionBits(boundInfo, &llvmIrInstruction));
+			}
+		}
+	}
+	if (quantizedInstructions.empty())
+	{
+		return;
+	}
+	flexprint(N->Fe, N->Fm, N->Fpinfo, "\tauto quantization: %zu instructions\n", quantizedInstructions.size());
+
+	/*
+	 * the position right after the definition of a value, after the PHIs of its block
+	 * */
+	auto getInsertPoint = [&](Value * value) -> Instruction * {
+		if (auto llvmIrInstruction = dyn_cast<Instruction>(value))
+		{
+			if (isa<PHINode>(llvmIrInstruction))
+				return llvmIrInstruction->getParent()->getFirstNonPHI();
+			return llvmIrInstruction->getNextNode();
+		}
+		return &*llvmIrFunction.getEntryBlock().getFirstInsertionPt();
+	};
+
+	/*
+	 * 3. the Q-format value of a floating-point value that is not quantized, converted once
+	 * */
+	std::map<Value *, Value *> fixedValues;
+	auto convertToFixed = [&](Value * value) -> Value * {
+		auto fvIt = fixedValues.find(value);
+		if (fvIt != fixedValues.end())
+			return fvIt->second;
+		int	    valueBits = getOperandFractionBits(boundInfo, value);
+		IRBuilder<> Builder(getInsertPoint(value));
+		Value *	    scaledValue = Builder.CreateFMul(value, ConstantFP::get(value->getType(), std::ldexp(1.0, valueBits)));
+		Function *  saturation	= Intrinsic::getDeclaration(llvmIrModule, Intrinsic::fptosi_sat, {fixedType, value->getType()});
+		Value *	    fixedValue	= Builder.CreateCall(saturation, {scaledValue});
+		fractionBits.emplace(value, valueBits);
+		fixedValues.emplace(value, fixedValue);
+		return fixedValue;
+	};
+
+	/*
+	 * 2. an operand in Q format with `targetBits` fraction bits, inserted before `insertPoint`
+	 * */
+	auto getFixedOperand = [&](Value * operand, int targetBits, Instruction * insertPoint) -> Value * {
+		IRBuilder<> Builder(insertPoint);
+		if (auto constFp = dyn_cast<ConstantFP>(operand))
+		{
+			double constValue = constFp->getValueAPF().convertToDouble();
+			return ConstantInt::get(fixedType, static_cast<int64_t>(std::llround(std::ldexp(constValue, targetBits))), true);
+		}
+		Value * fixedValue = convertToFixed(operand);
+		int	operandBits = fractionBits[operand];
+		if (operandBits > targetBits)
+			return Builder.CreateAShr(fixedValue, operandBits - targetBits);
+		if (operandBits < targetBits)
+			return Builder.CreateShl(fixedValue, targetBits - operandBits);
+		return fixedValue;
+	};
+
+	/*
+	 * the PHIs are created first, their incoming values may be quantized later
+	 * */
+	for (Instruction * llvmIrInstruction : quantizedInstructions)
+	{
+		if (auto llvmIrPhiNode = dyn_cast<PHINode>(llvmIrInstruction))
+		{
+			IRBuilder<> Builder(llvmIrPhiNode);
+			fixedValues.emplace(llvmIrPhiNode, Builder.CreatePHI(fixedType, llvmIrPhiNode->getNumIncomingValues()));
+		}
+	}
+	std::map<Instruction *, Value *> fixedComparisons;
+	std::map<Instruction *, Value *> fixedConversions;
+	for (Instruction * llvmIrInstruction : quantizedInstructions)
+	{
+		if (isa<PHINode>(llvmIrInstruction))
+			continue;
+		int	    resultBits = llvmIrInstruction->getType()->isFloatingPointTy() ? fractionBits[llvmIrInstruction] : 0;
+		IRBuilder<> Builder(llvmIrInstruction);
+		Value *	    fixedValue = nullptr;
+		switch (llvmIrInstruction->getOpcode())
+		{
+			case Instruction::FAdd:
+			case Instruction::FSub:
+			{
+				/*
+				 * the sum fits in the format of its range, so the operands are aligned to the fewest fraction bits
+				 * */
+				int alignedBits = min(resultBits, min(getOperandFractionBits(boundInfo, llvmIrInstruction->getOperand(0)),
+								      getOperandFractionBits(boundInfo, llvmIrInstruction->getOperand(1))));
+				Value * lhs	= getFixedOperand(llvmIrInstruction->getOperand(0), alignedBits, llvmIrInstruction);
+				Value * rhs	= getFixedOperand(llvmIrInstruction->getOperand(1), alignedBits, llvmIrInstruction);
+				fixedValue	= llvmIrInstruction->getOpcode() == Instruction::FAdd ? Builder.CreateAdd(lhs, rhs)
+												       : Builder.CreateSub(lhs, rhs);
+				if (alignedBits < resultBits)
+					fixedValue = Builder.CreateShl(fixedValue, resultBits - alignedBits);
+				break;
+			}
+			case Instruction::FMul:
+			{
+				int	lhsBits	 = getOperandFractionBits(boundInfo, llvmIrInstruction->getOperand(0));
+				int	rhsBits	 = getOperandFractionBits(boundInfo, llvmIrInstruction->getOperand(1));
+				Value * lhs	 = Builder.CreateSExt(getFixedOperand(llvmIrInstruction->getOperand(0), lhsBits, llvmIrInstruction), productType);
+				Value * rhs	 = Builder.CreateSExt(getFixedOperand(llvmIrInstruction->getOperand(1), rhsBits, llvmIrInstruction), productType);
+				Value * product	 = Builder.CreateMul(lhs, rhs);
+				int	shiftBits = lhsBits + rhsBits - resultBits;
+				product		 = shiftBits >= 0 ? Builder.CreateAShr(product, shiftBits) : Builder.CreateShl(product, -shiftBits);
+				fixedValue	 = Builder.CreateTrunc(product, fixedType);
+				break;
+			}
+			case Instruction::FDiv:
+			{
+				int	dividendBits = getOperandFractionBits(boundInfo, llvmIrInstruction->getOperand(0));
+				int	divisorBits  = getOperandFractionBits(boundInfo, llvmIrInstruction->getOperand(1));
+				Value * dividend     = Builder.CreateSExt(getFixedOperand(llvmIrInstruction->getOperand(0), dividendBits, llvmIrInstruction), productType);
+				Value * divisor	     = Builder.CreateSExt(getFixedOperand(llvmIrInstruction->getOperand(1), divisorBits, llvmIrInstruction), productType);
+				dividend	     = Builder.CreateShl(dividend, resultBits - dividendBits + divisorBits);
+				fixedValue	     = Builder.CreateTrunc(Builder.CreateSDiv(dividend, divisor), fixedType);
+				break;
+			}
+			case Instruction::FNeg:
+				fixedValue = Builder.CreateNeg(getFixedOperand(llvmIrInstruction->getOperand(0), resultBits, llvmIrInstruction));
+				break;
+			case Instruction::FPExt:
+			case Instruction::FPTrunc:
+				fixedValue = getFixedOperand(llvmIrInstruction->getOperand(0), resultBits, llvmIrInstruction);
+				break;
+			case Instruction::Select:
+				fixedValue = Builder.CreateSelect(llvmIrInstruction->getOperand(0),
+								  getFixedOperand(llvmIrInstruction->getOperand(1), resultBits, llvmIrInstruction),
+								  getFixedOperand(llvmIrInstruction->getOperand(2), resultBits, llvmIrInstruction));
+				break;
+			case Instruction::SIToFP:
+			case Instruction::UIToFP:
+			{
+				/*
+				 * the integer fits in the integer bits of the format, as the range of the result is its range
+				 * */
+				bool	isSigned = llvmIrInstruction->getOpcode() == Instruction::SIToFP;
+				Value * integer	 = Builder.CreateIntCast(llvmIrInstruction->getOperand(0), fixedType, isSigned);
+				fixedValue	 = Builder.CreateShl(integer, resultBits);
+				break;
+			}
+			case Instruction::FPToSI:
+			case Instruction::FPToUI:
+			{
+				/*
+				 * the conversion rounds toward 0 like the division, the shift would round toward -infinity
+				 * */
+				Value * operand	   = llvmIrInstruction->getOperand(0);
+				Value * integer	   = Builder.CreateSDiv(fixedValues[operand], ConstantInt::get(fixedType, 1ULL << fractionBits[operand]));
+				bool	isSigned   = llvmIrInstruction->getOpcode() == Instruction::FPToSI;
+				fixedConversions.emplace(llvmIrInstruction, Builder.CreateIntCast(integer, llvmIrInstruction->getType(), isSigned));
+				break;
+			}
+			case Instruction::FCmp:
+			{
+				int alignedBits = min(getOperandFractionBits(boundInfo, llvmIrInstruction->getOperand(0)),
+						      getOperandFractionBits(boundInfo, llvmIrInstruction->getOperand(1)));
+				Value * lhs	= getFixedOperand(llvmIrInstruction->getOperand(0), alignedBits, llvmIrInstruction);
+				Value * rhs	= getFixedOperand(llvmIrInstruction->getOperand(1), alignedBits, llvmIrInstruction);
+				fixedComparisons.emplace(llvmIrInstruction,
+							 Builder.CreateICmp(getFixedPointPredicate(cast<FCmpInst>(llvmIrInstruction)->getPredicate()), lhs, rhs));
+				break;
+			}
+			default:
+				break;
+		}
+		if (fixedValue != nullptr)
+			fixedValues.emplace(llvmIrInstruction, fixedValue);
+	}
+	for (Instruction * llvmIrInstruction : quantizedInstructions)
+	{
+		if (auto llvmIrPhiNode = dyn_cast<PHINode>(llvmIrInstruction))
+		{
+			auto fixedPhiNode = cast<PHINode>(fixedValues[llvmIrPhiNode]);
+			for (unsigned idx = 0; idx < llvmIrPhiNode->getNumIncomingValues(); idx++)
+			{
+				BasicBlock * incomingBlock = llvmIrPhiNode->getIncomingBlock(idx);
+				fixedPhiNode->addIncoming(getFixedOperand(llvmIrPhiNode->getIncomingValue(idx), fractionBits[llvmIrPhiNode],
+									  incomingBlock->getTerminator()),
+							  incomingBlock);
+			}
+		}
+	}
+
+	/*
+	 * 4. the users that are not quantized get the value back in floating point
+	 * */
+	std::set<Instruction *> quantizedSet(quantizedInstructions.begin(), quantizedInstructions.end());
+	for (Instruction * llvmIrInstruction : quantizedInstructions)
+	{
+		if (fixedComparisons.count(llvmIrInstruction))
+		{
+			llvmIrInstruction->replaceAllUsesWith(fixedComparisons[llvmIrInstruction]);
+			continue;
+		}
+		if (fixedConversions.count(llvmIrInstruction))
+		{
+			llvmIrInstruction->replaceAllUsesWith(fixedConversions[llvmIrInstruction]);
+			continue;
+		}
+		Value * floatValue = nullptr;
+		for (Use & use : make_early_inc_range(llvmIrInstruction->uses()))
+		{
+			auto userInstruction = dyn_cast<Instruction>(use.getUser());
+			if (userInstruction != nullptr && quantizedSet.count(userInstruction))
+				continue;
+			if (floatValue == nullptr)
+			{
+				IRBuilder<> Builder(getInsertPoint(fixedValues[llvmIrInstruction]));
+				floatValue = Builder.CreateFMul(Builder.CreateSIToFP(fixedValues[llvmIrInstruction], llvmIrInstruction->getType()),
+								ConstantFP::get(llvmIrInstruction->getType(), std::ldexp(1.0, -fractionBits[llvmIrInstruction])));
+			}
+			use.set(floatValue);
 		}
 	}
+	for (Instruction * llvmIrInstruction : quantizedInstructions)
+	{
+		llvmIrInstruction->dropAllReferences();
+	}
+	for (Instruction * llvmIrInstruction : quantizedInstructions)
+	{
+		llvmIrInstruction->eraseFromParent();
+	}
 	return;
 }
 }
@@ -36,6 +36,9 @@ extern "C"
 {
 #endif /* __cplusplus */
 
+int
+getFractionBits(const std::pair<double, double> & range);
+
 void
 irPassLLVMIRAutoQuantization(State * N, BoundInfo * boundInfo, llvm::Function & llvmIrFunction);
 
@@ -48,7 +48,7 @@ const bool valueRangeDebug = false;
 
 std::pair<bool, std::pair<double, double>>
 getGEPArrayRange(State * N, GetElementPtrInst * llvmIrGetElePtrInstruction,
-		 std::map<llvm::Value *, std::pair<double, double>> virtualRegisterRange)
+		 const ValueRangeMap & virtualRegisterRange)
 {
 	/*
 	 * if it's a constant
@@ -129,9 +129,12 @@ getGEPArrayRange(State * N, GetElementPtrInst * llvmIrGetElePtrInstruction,
 				auto		      vrRangeIt = virtualRegisterRange.find(arrIndexValue);
 				if (vrRangeIt != virtualRegisterRange.end())
 				{
-					// todo: if we need assert or other check here?
-					uint32_t min = vrRangeIt->second.first < 0 ? 0 : vrRangeIt->second.first;
-					uint32_t max = vrRangeIt->second.second < 0 ? 0 : vrRangeIt->second.second;
+					/*
+					 * an index out of the bounds is undefined, so only the elements in the array are joined
+					 * */
+					double	 lastIndex = constArr->getNumElements() - 1;
+					uint32_t min	   = max(0.0, min(vrRangeIt->second.first, lastIndex));
+					uint32_t max	   = max(0.0, min(vrRangeIt->second.second, lastIndex));
 					for (size_t idx = min; idx <= max; idx++)
 					{
 						dynIdx.emplace_back(idx);
@@ -172,16 +175,35 @@ getGEPArrayRange(State * N, GetElementPtrInst * llvmIrGetElePtrInstruction,
  * if we know the range of %a, then the range of %x should be [min(min_a, 5), max(max_a, 5)]
  *
  * but it could be more accuracy for IntSet.
+ *
+ * An incoming edge whose block has not been interpreted yet (e.g. the back edge of a loop
+ * on the first visit of its header) contributes nothing, as its value is still unknown.
+ * The range of an incoming value on its edge is looked up in `incomingRanges` first,
+ * which holds the ranges the branches leading to this PHI restrict it to.
  * */
 bool
 checkPhiRange(State * N, PHINode * phiNode, BoundInfo * boundInfo,
-	      const std::map<llvm::Value *, std::vector<std::pair<double, double>>> & virtualRegisterVectorRange)
+	      const std::map<llvm::Value *, std::vector<std::pair<double, double>>> & virtualRegisterVectorRange,
+	      const std::set<BasicBlock *> &					      visitedBlocks,
+	      const std::map<BasicBlock *, std::map<Value *, std::pair<double, double>>> & incomingRanges)
 {
 	std::vector<double>				    minValueVec, maxValueVec;
 	std::vector<std::vector<std::pair<double, double>>> minPHIValueVectors, maxPHIValueVectors;
 	for (size_t idx = 0; idx < phiNode->getNumIncomingValues(); idx++)
 	{
 		auto phiValue = phiNode->getIncomingValue(idx);
+		if (visitedBlocks.find(phiNode->getIncomingBlock(idx)) == visitedBlocks.end())
+		{
+			continue;
+		}
+		if (auto phiInstruction = dyn_cast<Instruction>(phiValue))
+		{
+			if (visitedBlocks.find(phiInstruction->getParent()) == visitedBlocks.end() &&
+			    boundInfo->virtualRegisterRange.find(phiValue) == boundInfo->virtualRegisterRange.end())
+			{
+				continue;
+			}
+		}
 		if (isa<llvm::Constant>(phiValue))
 		{
 			if (ConstantFP * constFp = llvm::dyn_cast<llvm::ConstantFP>(phiValue))
@@ -226,6 +248,13 @@ checkPhiRange(State * N, PHINode * phiNode, BoundInfo * boundInfo,
 		}
 		else
 		{
+			auto irIt = incomingRanges.find(phiNode->getIncomingBlock(idx));
+			if (irIt != incomingRanges.end() && irIt->second.find(phiValue) != irIt->second.end())
+			{
+				minValueVec.emplace_back(irIt->second.at(phiValue).first);
+				maxValueVec.emplace_back(irIt->second.at(phiValue).second);
+				continue;
+			}
 			auto vrRangeIt = boundInfo->virtualRegisterRange.find(phiValue);
 			if (vrRangeIt != boundInfo->virtualRegisterRange.end())
 			{
@@ -477,493 +506,1834 @@ modInterval(const int64_t lhsLow, const int64_t lhsHigh, const int64_t rhsLow, c
 	}
 }
 
-std::vector<std::string>
-getDisjointUnionSet(const std::bitset<64> & lowerBinSet,
-		    const std::bitset<64> & upperBinSet, uint8_t bitSize)
+/*
+ * the values of an integer interval, as a ConstantRange of `bitWidth` bits.
+ * Integers are signless in LLVM IR, so a negative bound is read as signed and a bound above the signed maximum as unsigned.
+ * */
+ConstantRange
+getIntervalConstantRange(const std::pair<double, double> & range, unsigned bitWidth)
 {
-	std::string lowerBin = lowerBinSet.to_string();
-	std::string upperBin = upperBinSet.to_string();
-	lowerBin	     = lowerBin.substr(lowerBin.size() - bitSize);
-	upperBin	     = upperBin.substr(upperBin.size() - bitSize);
-	std::vector<std::string> disjointUnionSet;
-	std::string		 binStrEle;
-
-	/*
-	 * the turning point is where lowerBin different from upperBin
-	 * */
-	std::string xorStr = (lowerBinSet ^ upperBinSet).to_string();
-	xorStr		   = xorStr.substr(xorStr.size() - bitSize);
-	if (xorStr.find_first_of('1') == std::string::npos)
+	double lowerBound = std::ceil(range.first);
+	double upperBound = std::floor(range.second);
+	if (!std::isfinite(lowerBound) || !std::isfinite(upperBound) || lowerBound > upperBound ||
+	    lowerBound < -std::ldexp(1.0, bitWidth - 1) || upperBound >= std::ldexp(1.0, bitWidth) ||
+	    upperBound - lowerBound >= std::ldexp(1.0, bitWidth) - 1)
 	{
-		/*
-		 * lower bound == higher bound, return with itself
-		 * */
-		disjointUnionSet.emplace_back(lowerBin);
-		return disjointUnionSet;
+		return ConstantRange::getFull(bitWidth);
 	}
-	const auto turningPoint = xorStr.find_first_of('1');
-	/*
-	 * for the right-most continuously bit of lower bound,
-	 *  if they're '0', then change them to 'x'
-	 *  if it's '1', then emplace '1'
-	 */
-	const auto lowerStartPos = lowerBin.substr(1).find_last_of('1') + 1;
-	if (lowerStartPos == bitSize - 1)
+	APInt lower = lowerBound < 0 ? APInt(bitWidth, static_cast<int64_t>(lowerBound), true)
+				     : APInt(bitWidth, static_cast<uint64_t>(lowerBound));
+	APInt upper = upperBound < 0 ? APInt(bitWidth, static_cast<int64_t>(upperBound), true)
+				     : APInt(bitWidth, static_cast<uint64_t>(upperBound));
+	return ConstantRange::getNonEmpty(lower, upper + 1);
+}
+
+/*
+ * the bits known from an interval: the leading bits its bounds agree on
+ * */
+KnownBits
+getIntervalKnownBits(const ConstantRange & range)
+{
+	KnownBits knownBits(range.getBitWidth());
+	if (range.isFullSet() || range.isEmptySet() || (range.isWrappedSet() && range.isSignWrappedSet()))
 	{
-		disjointUnionSet.emplace_back(lowerBin);
+		return knownBits;
 	}
-	else
-	{
-		/* substitute all the right most '0' in lowerBin to 'x'
-		 *  e.g.
-		 *  ([010100], [011101]) -> {[0101xx], ...}
-		 * but if the turning point is righter than 'lowerStartPos'
-		 * only substitute bits right after the turning point
-		 *  e.g.
-		 *  ([01000], [01110]) -> {[010xx], ...}
+	APInt	 lower	       = range.isWrappedSet() ? range.getSignedMin() : range.getUnsignedMin();
+	APInt	 upper	       = range.isWrappedSet() ? range.getSignedMax() : range.getUnsignedMax();
+	unsigned commonBitNum = (lower ^ upper).countLeadingZeros();
+	APInt	 commonMask   = APInt::getHighBitsSet(range.getBitWidth(), commonBitNum);
+	knownBits.One	       = lower & commonMask;
+	knownBits.Zero	       = ~lower & commonMask;
+	return knownBits;
+}
+
+/*
+ * the range of `and`, `or` or `xor`, from the reduced product of the intervals and the known bits of the operands.
+ * The bits of an operand are known from its interval and from the instructions computing it (LLVM KnownBits),
+ * the operation is applied in both domains, and the bits known in the result narrow its interval.
+ * The operands are split at the sign bit first, as the values of each sign share their leading bits.
+ * */
+std::pair<double, double>
+bitwiseRange(BinaryOperator * llvmIrBinaryOperator,
+	     Value * leftOperand, const std::pair<double, double> & leftRange,
+	     Value * rightOperand, const std::pair<double, double> & rightRange)
+{
+	auto &	  dataLayout	    = llvmIrBinaryOperator->getModule()->getDataLayout();
+	unsigned  bitWidth	    = llvmIrBinaryOperator->getType()->getScalarSizeInBits();
+	KnownBits leftInstKnownBits  = computeKnownBits(leftOperand, dataLayout);
+	KnownBits rightInstKnownBits = computeKnownBits(rightOperand, dataLayout);
+	auto	  getSignParts	    = [bitWidth](const std::pair<double, double> & range) {
+		ConstantRange		   constantRange = getIntervalConstantRange(range, bitWidth);
+		std::vector<ConstantRange> signParts;
+		for (const auto & signHalf : {ConstantRange(APInt::getZero(bitWidth), APInt::getSignedMinValue(bitWidth)),
+					      ConstantRange(APInt::getSignedMinValue(bitWidth), APInt::getZero(bitWidth))})
+		{
+			ConstantRange signPart = constantRange.intersectWith(signHalf);
+			if (!signPart.isEmptySet())
+			{
+				signParts.push_back(signPart);
+			}
+		}
+		return signParts;
+	};
+	auto getPartKnownBits = [](const KnownBits & instKnownBits, const ConstantRange & part) {
+		KnownBits knownBits = getIntervalKnownBits(part);
+		knownBits.Zero |= instKnownBits.Zero;
+		knownBits.One |= instKnownBits.One;
+		/*
+		 * the interval has been widened or narrowed into values the instructions can't give
 		 * */
-		const auto substituteBit = lowerStartPos > turningPoint ? lowerStartPos : turningPoint;
-		binStrEle		 = lowerBin.substr(0, substituteBit + 1);
-		binStrEle.append(bitSize - substituteBit - 1, 'x');
-		disjointUnionSet.emplace_back(binStrEle);
-		binStrEle.clear();
-	}
+		return knownBits.hasConflict() ? instKnownBits : knownBits;
+	};
 	/*
-	 * when splitting the lower bound, iterate from right to left
+	 * the result is signed if an operand is
 	 * */
-	for (int idx = lowerStartPos - 1; idx > turningPoint; idx--)
+	bool			      isSigned	      = leftRange.first < 0 || rightRange.first < 0;
+	ConstantRange::PreferredRangeType preferredType = isSigned ? ConstantRange::Signed : ConstantRange::Unsigned;
+	ConstantRange		      resultRange     = ConstantRange::getEmpty(bitWidth);
+	for (const auto & leftPart : getSignParts(leftRange))
 	{
-		if (idx < 0)
-			break;
-		/*
-		 * substitute the '0' to '1' and append with 'x' to get the large number
-		 * */
-		if (lowerBin[idx] == '0')
+		for (const auto & rightPart : getSignParts(rightRange))
 		{
-			binStrEle = lowerBin.substr(0, idx) + '1';
-			binStrEle.append(bitSize - idx - 1, 'x');
-			disjointUnionSet.emplace_back(binStrEle);
-			binStrEle.clear();
+			KnownBits     leftKnownBits  = getPartKnownBits(leftInstKnownBits, leftPart);
+			KnownBits     rightKnownBits = getPartKnownBits(rightInstKnownBits, rightPart);
+			KnownBits     partKnownBits(bitWidth);
+			ConstantRange partRange = ConstantRange::getFull(bitWidth);
+			switch (llvmIrBinaryOperator->getOpcode())
+			{
+				case Instruction::And:
+					partKnownBits = leftKnownBits & rightKnownBits;
+					partRange     = leftPart.binaryAnd(rightPart);
+					break;
+				case Instruction::Or:
+					partKnownBits = leftKnownBits | rightKnownBits;
+					partRange     = leftPart.binaryOr(rightPart);
+					break;
+				case Instruction::Xor:
+					partKnownBits = leftKnownBits ^ rightKnownBits;
+					partRange     = leftPart.binaryXor(rightPart);
+					break;
+				default:
+					assert(false && "unknown bit_wise operation");
+			}
+			partRange   = partRange.intersectWith(ConstantRange::fromKnownBits(partKnownBits, isSigned), preferredType);
+			resultRange = resultRange.unionWith(partRange, preferredType);
 		}
 	}
+	if (resultRange.isEmptySet())
+	{
+		resultRange = ConstantRange::getFull(bitWidth);
+	}
+	if (isSigned)
+	{
+		return std::make_pair(resultRange.getSignedMin().getSExtValue(), resultRange.getSignedMax().getSExtValue());
+	}
+	return std::make_pair(resultRange.getUnsignedMin().getZExtValue(), resultRange.getUnsignedMax().getZExtValue());
+}
 
+/*
+ * limits of the fixpoint iteration in rangeAnalysis
+ * */
+enum FixpointLimit {
+	/*
+	 * visits of a loop header before a growing range is widened
+	 * */
+	WideningDelay	 = 3,
 	/*
-	 * for the right-most continuously bit of upper bound,
-	 *  if they're '1', then change them to 'x'
-	 *  if it's '0', then emplace '0'
+	 * visits of each block in the narrowing phase
 	 * */
-	const auto upperEndPos = upperBin.substr(1).find_last_of('0') + 1;
-	if (upperEndPos == bitSize - 1)
+	NarrowingVisits	 = 2,
+	/*
+	 * safety net for blocks that keep being re-queued
+	 * */
+	MaxBlockVisits	 = 64,
+};
+
+/*
+ * the widest range a value of this type can hold, which is where widening jumps to.
+ * Integers are signless in LLVM IR, so the bound covers both the signed and the unsigned reading.
+ * Floating-point values may overflow to infinity, so their bound is infinite.
+ * */
+std::pair<double, double>
+getTypeBound(Type * valueType)
+{
+	if (valueType->isPointerTy())
 	{
-		disjointUnionSet.emplace_back(upperBin);
+		valueType = valueType->getPointerElementType();
 	}
-	else
+	if (valueType->isIntegerTy(1))
 	{
-		/* substitute all of the right most '1' in upperBin to 'x'.
-		 *  e.g.
-		 *  ([010001], [011011]) -> {[0110xx], ...}
-		 * but if the turning point is righter than 'upperEndPos'
-		 * only substitute bits right after the turning point
-		 *  e.g.
-		 *  ([010001], [011111]) -> {[011xxx], ...}
-		 * */
-		const auto substituteBit = upperEndPos > turningPoint ? upperEndPos : turningPoint;
-		binStrEle		 = upperBin.substr(0, substituteBit + 1);
-		binStrEle.append(bitSize - substituteBit - 1, 'x');
-		disjointUnionSet.emplace_back(binStrEle);
-		binStrEle.clear();
+		return std::make_pair(0, 1);
 	}
-	/*
-	 * when splitting the upper bound, iterate from left to right
-	 * */
-	for (int idx = turningPoint + 1; idx < upperEndPos; idx++)
+	else if (valueType->isIntegerTy())
 	{
-		/*
-		 * substitute the '1' to '0' and append with 'x' to get the smaller number
-		 * */
-		if (upperBin[idx] == '1')
+		unsigned bitWidth = valueType->getIntegerBitWidth();
+		return std::make_pair(-std::ldexp(1.0, bitWidth - 1), std::ldexp(1.0, bitWidth) - 1);
+	}
+	return std::make_pair(-std::numeric_limits<double>::infinity(), std::numeric_limits<double>::infinity());
+}
+
+/*
+ * interval widening: a bound that moved since the last visit jumps to the bound of the type,
+ * and one that moved past it jumps to infinity, as the ranges don't wrap around
+ * */
+std::pair<double, double>
+widenRange(const std::pair<double, double> & oldRange, const std::pair<double, double> & newRange, Type * valueType)
+{
+	auto   typeBound  = getTypeBound(valueType);
+	double lowerBound = oldRange.first;
+	double upperBound = oldRange.second;
+	if (newRange.first < oldRange.first)
+	{
+		lowerBound = newRange.first < typeBound.first ? -std::numeric_limits<double>::infinity() : typeBound.first;
+	}
+	if (newRange.second > oldRange.second)
+	{
+		upperBound = newRange.second > typeBound.second ? std::numeric_limits<double>::infinity() : typeBound.second;
+	}
+	return std::make_pair(lowerBound, upperBound);
+}
+
+/*
+ * interval narrowing: keep the recomputed range if it is within the widened one.
+ * A recomputed range outside of it means the widened range does not hold,
+ * e.g. an operand lost its range on this visit, so cover both.
+ * */
+std::pair<double, double>
+narrowRange(const std::pair<double, double> & oldRange, const std::pair<double, double> & newRange)
+{
+	if (newRange.first >= oldRange.first && newRange.second <= oldRange.second)
+	{
+		return newRange;
+	}
+	return std::make_pair(min(oldRange.first, newRange.first), max(oldRange.second, newRange.second));
+}
+
+/*
+ * the ranges of the arguments of a call, `false` for an argument without range
+ */
+std::vector<std::pair<bool, std::pair<double, double>>>
+getCallArgRanges(CallInst * llvmIrCallInstruction, const BoundInfo * boundInfo)
+{
+	std::vector<std::pair<bool, std::pair<double, double>>> argRanges;
+	for (auto & arg : llvmIrCallInstruction->args())
+	{
+		auto vrRangeIt = boundInfo->virtualRegisterRange.find(arg.get());
+		if (vrRangeIt != boundInfo->virtualRegisterRange.end())
+		{
+			argRanges.emplace_back(true, vrRangeIt->second);
+		}
+		else
 		{
-			binStrEle = upperBin.substr(0, idx) + '0';
-			binStrEle.append(bitSize - idx - 1, 'x');
-			disjointUnionSet.emplace_back(binStrEle);
-			binStrEle.clear();
+			argRanges.emplace_back(false, std::make_pair(0, 0));
 		}
 	}
+	return argRanges;
+}
 
-	return disjointUnionSet;
+/*
+ * the range of a constant, or the range inferred for a value so far
+ * */
+bool
+getValueRange(Value * value, const BoundInfo * boundInfo, std::pair<double, double> & valueRange)
+{
+	if (auto constInt = dyn_cast<ConstantInt>(value))
+	{
+		double constValue = static_cast<double>(constInt->getSExtValue());
+		valueRange	  = std::make_pair(constValue, constValue);
+		return true;
+	}
+	if (auto constFp = dyn_cast<ConstantFP>(value))
+	{
+		double constValue = constFp->getValueAPF().convertToDouble();
+		valueRange	  = std::make_pair(constValue, constValue);
+		return true;
+	}
+	auto vrRangeIt = boundInfo->virtualRegisterRange.find(value);
+	if (vrRangeIt == boundInfo->virtualRegisterRange.end())
+	{
+		return false;
+	}
+	valueRange = vrRangeIt->second;
+	return true;
 }
 
-enum BitSetType {
-	HAS_BIT	 = 1,
-	ALL_SAME = 2,
-	ALL_DIFF = 3,
+/*
+ * accesses visited in MemorySSA to find the stores reaching a load
+ * */
+enum MemoryAccessLimit {
+	MaxReachingAccesses = 32,
 };
 
-using bitSets	= std::vector<std::vector<size_t>>;
-using signedBit = std::pair<bool, std::vector<size_t>>;
-struct hashFunc {
-	size_t
-	operator()(const signedBit & x) const
+/*
+ * join the ranges of the stores to the address of a load that are reached from `memoryAccess`.
+ * A store inside a loop contributes the values it stored in all iterations, from `loopStoreRanges`.
+ * Fails if a reaching access is not such a store, e.g. a call, a store to an address that may alias,
+ * or the memory on entry of the function.
+ * */
+bool
+joinReachingStoreRanges(MemorySSA & memorySSA, AAResults & aliasAnalysis,
+			const std::map<Instruction *, std::pair<double, double>> & loopStoreRanges, const BoundInfo * boundInfo,
+			LoadInst * llvmIrLoadInstruction, MemoryAccess * memoryAccess, std::set<MemoryAccess *> & visitedAccesses,
+			bool & hasRange, std::pair<double, double> & loadRange)
+{
+	if (!visitedAccesses.emplace(memoryAccess).second)
+	{
+		return true;
+	}
+	if (visitedAccesses.size() > MaxReachingAccesses || memorySSA.isLiveOnEntryDef(memoryAccess))
+	{
+		return false;
+	}
+	MemoryLocation loadLocation = MemoryLocation::get(llvmIrLoadInstruction);
+	if (auto memoryPhi = dyn_cast<MemoryPhi>(memoryAccess))
 	{
-		size_t secondXor;
-		for (const auto & s : x.second)
+		for (auto & incomingAccess : memoryPhi->incoming_values())
 		{
-			if (s == SIZE_MAX)
-				return x.first;
-			secondXor ^= s;
+			MemoryAccess * clobberAccess = memorySSA.getWalker()->getClobberingMemoryAccess(cast<MemoryAccess>(incomingAccess),
+													 loadLocation);
+			if (!joinReachingStoreRanges(memorySSA, aliasAnalysis, loopStoreRanges, boundInfo, llvmIrLoadInstruction,
+						     clobberAccess, visitedAccesses, hasRange, loadRange))
+				return false;
 		}
-		return x.first ^ secondXor;
+		return true;
+	}
+	auto memoryDef		    = dyn_cast<MemoryDef>(memoryAccess);
+	auto llvmIrStoreInstruction = memoryDef == nullptr ? nullptr : dyn_cast_or_null<StoreInst>(memoryDef->getMemoryInst());
+	if (llvmIrStoreInstruction == nullptr ||
+	    llvmIrStoreInstruction->getValueOperand()->getType() != llvmIrLoadInstruction->getType() ||
+	    aliasAnalysis.alias(MemoryLocation::get(llvmIrStoreInstruction), loadLocation) != AliasResult::MustAlias)
+	{
+		return false;
+	}
+	std::pair<double, double> storeRange;
+	auto			  lsIt = loopStoreRanges.find(llvmIrStoreInstruction);
+	if (lsIt != loopStoreRanges.end())
+	{
+		storeRange = lsIt->second;
+	}
+	else if (!getValueRange(llvmIrStoreInstruction->getValueOperand(), boundInfo, storeRange))
+	{
+		return false;
 	}
+	loadRange = hasRange ? std::make_pair(min(loadRange.first, storeRange.first), max(loadRange.second, storeRange.second))
+			     : storeRange;
+	hasRange  = true;
+	return true;
+}
+
+/*
+ * limits of the array summaries
+ * */
+enum ArrayRangeLimit {
+	/*
+	 * arrays with more elements share a segment between neighbouring elements
+	 * */
+	MaxArraySegments = 64,
 };
-using signedBitSets = std::unordered_set<signedBit, hashFunc>;
-
-signedBitSets
-getBitPos(bitSets lhsVecs, bitSets rhsVecs,
-	  std::vector<std::string> lhsDus,
-	  std::vector<std::string> rhsDus,
-	  const std::string &	   bitwiseFunc,
-	  BitSetType		   bsType)
+
+/*
+ * if the memory is only accessed by loads, stores to it, and calls through `base` and the pointers derived from it,
+ * i.e. rangeAnalysis sees all the stores to it
+ * */
+bool
+isArrayTracked(Value * base)
 {
-	signedBitSets		  res;
-	const std::vector<size_t> nonExit(1, SIZE_MAX);
-	for (size_t lhsIdx = 0; lhsIdx < lhsVecs.size(); lhsIdx++)
+	std::vector<Value *> pointers{base};
+	std::set<Value *>    visitedPointers{base};
+	while (!pointers.empty())
 	{
-		for (size_t rhsIdx = 0; rhsIdx < rhsVecs.size(); rhsIdx++)
+		Value * pointer = pointers.back();
+		pointers.pop_back();
+		for (User * user : pointer->users())
 		{
-			std::vector<size_t> tmpSamePos;
-			if (bsType == BitSetType::HAS_BIT)
-			{
-				std::set_union(lhsVecs[lhsIdx].begin(), lhsVecs[lhsIdx].end(),
-					       rhsVecs[rhsIdx].begin(), rhsVecs[rhsIdx].end(),
-					       std::back_inserter(tmpSamePos));
-			}
-			else if (bsType == BitSetType::ALL_SAME)
+			if (isa<GetElementPtrInst>(user) || isa<BitCastInst>(user))
 			{
-				std::set_intersection(lhsVecs[lhsIdx].begin(), lhsVecs[lhsIdx].end(),
-						      rhsVecs[rhsIdx].begin(), rhsVecs[rhsIdx].end(),
-						      std::back_inserter(tmpSamePos));
+				if (visitedPointers.emplace(user).second)
+					pointers.emplace_back(user);
 			}
-			else if (bsType == BitSetType::ALL_DIFF)
+			else if (auto llvmIrStoreInstruction = dyn_cast<StoreInst>(user))
 			{
-				std::set_difference(lhsVecs[lhsIdx].begin(), lhsVecs[lhsIdx].end(),
-						    rhsVecs[rhsIdx].begin(), rhsVecs[rhsIdx].end(),
-						    std::back_inserter(tmpSamePos));
+				if (llvmIrStoreInstruction->getValueOperand() == pointer)
+					return false;
 			}
-			else
-				assert(false && "unknown enum of BitSetType");
-			tmpSamePos = tmpSamePos.empty() ? nonExit : tmpSamePos;
-			if (bitwiseFunc == "and")
-			{
-				res.emplace(std::make_pair((lhsDus[lhsIdx][0] - 48) & (rhsDus[rhsIdx][0] - 48),
-							   tmpSamePos));
-			}
-			else if (bitwiseFunc == "or")
+			else if (auto llvmIrCallInstruction = dyn_cast<CallInst>(user))
 			{
-				res.emplace(std::make_pair((lhsDus[lhsIdx][0] - 48) | (rhsDus[rhsIdx][0] - 48),
-							   tmpSamePos));
+				/*
+				 * the callee could return the pointer
+				 * */
+				if (llvmIrCallInstruction->getType()->isPointerTy())
+					return false;
 			}
-			else
+			else if (!isa<LoadInst>(user) && !isa<ICmpInst>(user))
 			{
-				res.emplace(std::make_pair((lhsDus[lhsIdx][0] - 48) ^ (rhsDus[rhsIdx][0] - 48),
-							   tmpSamePos));
+				return false;
 			}
 		}
 	}
-	return res;
+	return true;
 }
 
-int64_t
-convertBin2Dec(const std::string & binResStr, const uint8_t bitSize)
+/*
+ * join `range` to the segments of the elements from `firstElement` to `lastElement`
+ * */
+bool
+joinArrayRange(ArrayRange & arrayRange, uint64_t firstElement, uint64_t lastElement, const std::pair<double, double> & range)
 {
-	int64_t res;
-	if (binResStr[0] == '1')
+	bool   changed	   = false;
+	size_t lastSegment = min(lastElement / arrayRange.segmentSize, arrayRange.segmentRanges.size() - 1);
+	for (size_t segment = min(firstElement / arrayRange.segmentSize, lastSegment); segment <= lastSegment; segment++)
 	{
-		auto tmpRes = binResStr;
-		/*
-		 * minus 1
-		 * */
-		if (tmpRes.back() == '1')
-		{
-			tmpRes.back() = '0';
-		}
-		else
+		auto & segmentRange = arrayRange.segmentRanges[segment];
+		auto   joinedRange  = std::make_pair(min(segmentRange.first, range.first), max(segmentRange.second, range.second));
+		if (joinedRange != segmentRange)
 		{
-			const size_t lastOne = tmpRes.find_last_of('1');
-			std::string  appendOne(bitSize - lastOne - 1, '1');
-			tmpRes[lastOne] = '0';
-			tmpRes		= tmpRes.substr(0, lastOne + 1) + appendOne;
+			segmentRange = joinedRange;
+			changed	     = true;
 		}
-		/*
-		 * negate
-		 * */
-		std::bitset<64> resDb(tmpRes);
-		res = -resDb.flip().to_ulong();
 	}
-	else
+	return changed;
+}
+
+/*
+ * the join of the segments of the elements from `firstElement` to `lastElement`, fails if nothing was stored to them
+ * */
+bool
+getArrayElementsRange(const ArrayRange & arrayRange, uint64_t firstElement, uint64_t lastElement, std::pair<double, double> & range)
+{
+	bool   hasRange	   = false;
+	size_t lastSegment = min(lastElement / arrayRange.segmentSize, arrayRange.segmentRanges.size() - 1);
+	for (size_t segment = min(firstElement / arrayRange.segmentSize, lastSegment); segment <= lastSegment; segment++)
 	{
-		std::bitset<64> resDb(binResStr);
-		res = resDb.to_ulong();
+		const auto & segmentRange = arrayRange.segmentRanges[segment];
+		if (segmentRange.first > segmentRange.second)
+			continue;
+		range	 = hasRange ? std::make_pair(min(range.first, segmentRange.first), max(range.second, segmentRange.second))
+				    : segmentRange;
+		hasRange = true;
 	}
-	return res;
+	return hasRange;
 }
 
-std::pair<int64_t, int64_t>
-bitwiseInterval(const int64_t lhsLow, const int64_t lhsHigh,
-		const int64_t rhsLow, const int64_t rhsHigh,
-		const std::string & bitwiseFunc)
+/*
+ * the summary of the array `base` points to, created on its first use.
+ * Fails for memory that isn't an array of integers or floating-point values, as scalars are left to MemorySSA.
+ * */
+ArrayRange *
+getArrayRange(BoundInfo * boundInfo, Value * base, const DataLayout & dataLayout)
 {
-	/*
-	 * 1. get the max bit size
-	 *  for negative number, it has the same or smaller remaining bit size with its positive,
-	 *  like -8="1...1000", 8="0...1000"; -14="1...0010", 14="0...1110"
-	 *  so when meet negative number, we get its max bit size with its absolute value.
-	 *  PS: the first bit is a sign bit.
-	 * */
-	std::vector<int64_t> ranges{std::abs(lhsLow), std::abs(lhsHigh),
-				    std::abs(rhsLow), std::abs(rhsHigh)};
-	auto		     maxAbsValue = std::max_element(ranges.begin(), ranges.end());
-	const auto	     maxSizePos	 = std::bitset<64>(*maxAbsValue).to_string().find('1');
-	const uint8_t	     bitSize	 = 64 - (maxSizePos == std::string::npos ? 63 : maxSizePos) + 1;
-
-	/*
-	 * 2. convert to binary number
-	 * */
-	std::bitset<64> llBin(lhsLow);
-	std::bitset<64> lhBin(lhsHigh);
-	std::bitset<64> rlBin(rhsLow);
-	std::bitset<64> rhBin(rhsHigh);
-
-	/*
-	 * 3. construct disjoint union set of each binary number
-	 * */
-	auto lhsDus = getDisjointUnionSet(llBin, lhBin, bitSize);
-	auto rhsDus = getDisjointUnionSet(rlBin, rhBin, bitSize);
-
-	/*
-	 * 4. for different bit_wise operation, we have different formulas and purpose
-	 * */
-	/*collect all bits index with '0' and '1'*/
-	bitSets lhsZeroVecs, lhsOneVecs;
-	for (const auto & lhs : lhsDus)
-	{
-		std::vector<size_t> matchZero, matchOne;
-		/*no need to check the sign bit*/
-		std::vector<size_t> indexVec(bitSize - 1);
-		std::iota(indexVec.begin(), indexVec.end(), 1);
-		std::copy_if(indexVec.begin(), indexVec.end(), std::back_inserter(matchZero), [lhs](size_t v) {
-			return lhs[v] == '0';
-		});
-		lhsZeroVecs.emplace_back(matchZero);
-		std::copy_if(indexVec.begin(), indexVec.end(), std::back_inserter(matchOne), [lhs](size_t v) {
-			return lhs[v] == '1';
-		});
-		lhsOneVecs.emplace_back(matchOne);
-	}
-	bitSets rhsZeroVecs, rhsOneVecs;
-	for (const auto & rhs : rhsDus)
+	auto arIt = boundInfo->arrayRange.find(base);
+	if (arIt != boundInfo->arrayRange.end())
 	{
-		std::vector<size_t> matchZero, matchOne;
-		/*no need to check the sign bit*/
-		std::vector<size_t> indexVec(bitSize - 1);
-		std::iota(indexVec.begin(), indexVec.end(), 1);
-		std::copy_if(indexVec.begin(), indexVec.end(), std::back_inserter(matchZero), [rhs](size_t v) {
-			return rhs[v] == '0';
-		});
-		rhsZeroVecs.emplace_back(matchZero);
-		std::copy_if(indexVec.begin(), indexVec.end(), std::back_inserter(matchOne), [rhs](size_t v) {
-			return rhs[v] == '1';
-		});
-		rhsOneVecs.emplace_back(matchOne);
-	}
-
-	signedBitSets sameOnePos    = getBitPos(lhsOneVecs, rhsOneVecs, lhsDus, rhsDus,
-						bitwiseFunc, BitSetType::ALL_SAME);
-	signedBitSets sameZeroPos   = getBitPos(lhsZeroVecs, rhsZeroVecs, lhsDus, rhsDus,
-						bitwiseFunc, BitSetType::ALL_SAME);
-	signedBitSets existOnePos   = getBitPos(lhsOneVecs, rhsOneVecs, lhsDus, rhsDus,
-						bitwiseFunc, BitSetType::HAS_BIT);
-	signedBitSets existZeroPos  = getBitPos(lhsZeroVecs, rhsZeroVecs, lhsDus, rhsDus,
-						bitwiseFunc, BitSetType::HAS_BIT);
-	signedBitSets diffFirstPos  = getBitPos(lhsOneVecs, rhsZeroVecs, lhsDus, rhsDus,
-						bitwiseFunc, BitSetType::ALL_SAME);
-	signedBitSets diffSecondPos = getBitPos(lhsZeroVecs, rhsOneVecs, lhsDus, rhsDus,
-						bitwiseFunc, BitSetType::ALL_SAME);
-	signedBitSets unionMin, unionMax;
-	// todo: there's a bug of xor: [-5, -4, 0, 1]
-	std::set_union(diffFirstPos.begin(), diffFirstPos.end(),
-		       diffSecondPos.begin(), diffSecondPos.end(),
-		       std::inserter(unionMin, unionMin.begin()));
-	std::set_union(sameZeroPos.begin(), sameZeroPos.end(),
-		       sameOnePos.begin(), sameOnePos.end(),
-		       std::inserter(unionMax, unionMax.begin()));
-
-	signedBitSets::iterator minResIt, maxResIt;
-	auto			compSingBit = [](const signedBit & a, const signedBit & b) {
-		   auto aIt = a.second.begin();
-		   auto bIt = b.second.begin();
-		   while (aIt != a.second.end() && bIt != b.second.end())
-		   {
-			   if ((*aIt) < (*bIt))
-				   return true;
-			   else if ((*aIt) > (*bIt))
-			   {
-				   return false;
-			   }
-			   else
-			   {
-				   aIt++;
-				   bIt++;
-			   }
-		   }
-		   return aIt != a.second.end();
-	};
-	if (bitwiseFunc == "and")
+		return &arIt->second;
+	}
+
+	Type * memoryType     = nullptr;
+	bool   unknownInitial = false;
+	if (auto llvmIrAllocaInstruction = dyn_cast<AllocaInst>(base))
 	{
-		/*
-		 * and:
-		 *  0 & 0 = 0, 0 & 1 = 0, 0 & x = 0
-		 *  1 & 1 = 1, 1 & x = x, x & x = x
-		 *   min: find the same '1', the larger the better, others are '0'
-		 *   max: find '0' exist, the larger the better, others are '1'
-		 * */
-		minResIt = std::max_element(sameOnePos.begin(), sameOnePos.end(),
-					    [compSingBit](const signedBit & a, const signedBit & b) {
-						    if (a.first < b.first)
-							    return true;
-						    else if (a.first > b.first)
-							    return false;
-						    else
-						    {
-							    return compSingBit(a, b);
-						    }
-					    });
-		maxResIt = std::max_element(existZeroPos.begin(), existZeroPos.end(),
-					    [compSingBit](const signedBit & a, const signedBit & b) {
-						    if (a.first > b.first)
-							    return true;
-						    else if (a.first < b.first)
-							    return false;
-						    else
-						    {
-							    return compSingBit(a, b);
-						    }
-					    });
-	}
-	else if (bitwiseFunc == "or")
+		if (llvmIrAllocaInstruction->isArrayAllocation())
+			return nullptr;
+		memoryType = llvmIrAllocaInstruction->getAllocatedType();
+	}
+	else if (auto globalVar = dyn_cast<GlobalVariable>(base))
 	{
 		/*
-		 *  or:
-		 *  1 | 1 = 1, 1 | 0 = 1, 1 | x = 1
-		 *  0 | 0 = 0, 0 | x = x, x | x = x
-		 *   min: find '1' exist, the larger the better, others are '0'
-		 *   max: find the same '0', the larger the better, others are '1'
+		 * the other functions could store to a variable, so only the constant ones are known
 		 * */
-		minResIt = std::max_element(existOnePos.begin(), existOnePos.end(),
-					    [compSingBit](const signedBit & a, const signedBit & b) {
-						    if (a.first < b.first)
-							    return true;
-						    else if (a.first > b.first)
-							    return false;
-						    else
-						    {
-							    return compSingBit(a, b);
-						    }
-					    });
-		maxResIt = std::max_element(sameZeroPos.begin(), sameZeroPos.end(),
-					    [compSingBit](const signedBit & a, const signedBit & b) {
-						    if (a.first > b.first)
-							    return true;
-						    else if (a.first < b.first)
-							    return false;
-						    else
-						    {
-							    return compSingBit(a, b);
-						    }
-					    });
-	}
-	else if (bitwiseFunc == "xor")
+		memoryType     = globalVar->getValueType();
+		unknownInitial = !globalVar->isConstant() || !globalVar->hasDefinitiveInitializer();
+	}
+	else if (isa<Argument>(base) && base->getType()->isPointerTy())
 	{
-		/*
-		 *  xor:
-		 *  0 ^ 0 = 0, 0 ^ 1 = 1, 1 ^ 1 = 0
-		 *  x ^ 0 = x, x ^ 1 = x, x ^ x = x
-		 *   min: find the different '0' + different '1', the larger the better, others are '0'
-		 *   max: find the same '0' + same '1', the larger the better, others are '1'
-		 * */
-		minResIt = std::max_element(unionMin.begin(), unionMin.end(),
-					    [compSingBit](const signedBit & a, const signedBit & b) {
-						    if (a.first < b.first)
-							    return true;
-						    else if (a.first > b.first)
-							    return false;
-						    else
-						    {
-							    return compSingBit(a, b);
-						    }
-					    });
-		maxResIt = std::max_element(unionMax.begin(), unionMax.end(),
-					    [compSingBit](const signedBit & a, const signedBit & b) {
-						    if (a.first > b.first)
-							    return true;
-						    else if (a.first < b.first)
-							    return false;
-						    else
-						    {
-							    return compSingBit(a, b);
-						    }
-					    });
+		memoryType     = base->getType()->getPointerElementType();
+		unknownInitial = true;
 	}
 	else
 	{
-		assert(false && "unknown bit_wise operation");
+		return nullptr;
+	}
+	Type * elementType = memoryType;
+	while (elementType->isArrayTy())
+	{
+		elementType = elementType->getArrayElementType();
+	}
+	if ((!elementType->isIntegerTy() && !elementType->isFloatingPointTy()) ||
+	    (!isa<Argument>(base) && !memoryType->isArrayTy()))
+	{
+		return nullptr;
 	}
 
-	std::string minResStr(bitSize, '0'), maxResStr(bitSize, '1');
-	minResStr[0] = minResIt->first ? '1' : '0';
-	for (const auto & bit : minResIt->second)
+	ArrayRange arrayRange;
+	arrayRange.elementSize	  = dataLayout.getTypeAllocSize(elementType).getFixedSize();
+	arrayRange.elementNum	  = isa<Argument>(base) ? 0 : dataLayout.getTypeAllocSize(memoryType).getFixedSize() / arrayRange.elementSize;
+	arrayRange.segmentSize	  = (arrayRange.elementNum + MaxArraySegments - 1) / MaxArraySegments;
+	arrayRange.segmentSize	  = arrayRange.segmentSize == 0 ? 1 : arrayRange.segmentSize;
+	arrayRange.unknownInitial = unknownInitial;
+	arrayRange.unknownStores  = !isa<GlobalVariable>(base) && !isArrayTracked(base);
+	size_t segmentNum	  = arrayRange.elementNum == 0 ? 1 : (arrayRange.elementNum + arrayRange.segmentSize - 1) / arrayRange.segmentSize;
+	arrayRange.segmentRanges.assign(segmentNum, std::make_pair(std::numeric_limits<double>::infinity(),
+								   -std::numeric_limits<double>::infinity()));
+
+	/*
+	 * the elements of a constant array
+	 * */
+	auto globalVar = dyn_cast<GlobalVariable>(base);
+	if (globalVar != nullptr && !unknownInitial)
 	{
-		if (bit != SIZE_MAX)
-		{
-			minResStr[bit] = '1';
-		}
+		uint64_t				elementIdx = 0;
+		std::function<void(llvm::Constant *)> joinInitializer = [&](llvm::Constant * initializer) {
+			uint64_t initElementNum = dataLayout.getTypeAllocSize(initializer->getType()).getFixedSize() / arrayRange.elementSize;
+			if (auto constDataSeq = dyn_cast<ConstantDataSequential>(initializer))
+			{
+				for (unsigned idx = 0; idx < constDataSeq->getNumElements(); idx++, elementIdx++)
+				{
+					double constValue = constDataSeq->getElementType()->isFloatingPointTy()
+								? constDataSeq->getElementAsAPFloat(idx).convertToDouble()
+								: static_cast<double>(constDataSeq->getElementAsAPInt(idx).getSExtValue());
+					joinArrayRange(arrayRange, elementIdx, elementIdx, std::make_pair(constValue, constValue));
+				}
+			}
+			else if (auto constArr = dyn_cast<ConstantArray>(initializer))
+			{
+				for (unsigned idx = 0; idx < constArr->getNumOperands(); idx++)
+				{
+					joinInitializer(constArr->getOperand(idx));
+				}
+			}
+			else if (isa<ConstantInt>(initializer) || isa<ConstantFP>(initializer))
+			{
+				std::pair<double, double> constRange;
+				getValueRange(initializer, boundInfo, constRange);
+				joinArrayRange(arrayRange, elementIdx, elementIdx, constRange);
+				elementIdx++;
+			}
+			else if (isa<ConstantAggregateZero>(initializer))
+			{
+				joinArrayRange(arrayRange, elementIdx, elementIdx + initElementNum - 1, std::make_pair(0, 0));
+				elementIdx += initElementNum;
+			}
+			else
+			{
+				arrayRange.unknownInitial = true;
+				elementIdx += initElementNum;
+			}
+		};
+		joinInitializer(globalVar->getInitializer());
 	}
-	maxResStr[0] = maxResIt->first ? '1' : '0';
-	for (const auto & bit : maxResIt->second)
+	return &boundInfo->arrayRange.emplace(base, arrayRange).first->second;
+}
+
+/*
+ * the range of the byte offset of `pointer` from `base`, through the GEPs and bitcasts in between
+ * */
+bool
+getPointerOffsetRange(Value * pointer, Value * base, const DataLayout & dataLayout, const BoundInfo * boundInfo,
+		      std::pair<double, double> & offsetRange)
+{
+	offsetRange = std::make_pair(0, 0);
+	while (pointer != base)
 	{
-		if (bit != SIZE_MAX)
+		if (auto gepOperator = dyn_cast<GEPOperator>(pointer))
+		{
+			for (auto gepTypeIt = gep_type_begin(gepOperator); gepTypeIt != gep_type_end(gepOperator); ++gepTypeIt)
+			{
+				if (StructType * structType = gepTypeIt.getStructTypeOrNull())
+				{
+					auto   fieldIndex  = cast<ConstantInt>(gepTypeIt.getOperand())->getZExtValue();
+					double fieldOffset = dataLayout.getStructLayout(structType)->getElementOffset(fieldIndex);
+					offsetRange.first += fieldOffset;
+					offsetRange.second += fieldOffset;
+					continue;
+				}
+				std::pair<double, double> indexRange;
+				if (!getValueRange(gepTypeIt.getOperand(), boundInfo, indexRange))
+					return false;
+				double stride = dataLayout.getTypeAllocSize(gepTypeIt.getIndexedType()).getFixedSize();
+				offsetRange.first += indexRange.first * stride;
+				offsetRange.second += indexRange.second * stride;
+			}
+			pointer = gepOperator->getPointerOperand();
+		}
+		else if (auto bitCastOperator = dyn_cast<BitCastOperator>(pointer))
+		{
+			pointer = bitCastOperator->getOperand(0);
+		}
+		else
 		{
-			maxResStr[bit] = '0';
+			return false;
 		}
 	}
+	return true;
+}
 
+/*
+ * the elements an access of `accessSize` bytes through `pointer` may touch,
+ * `isAligned` is false if it may not access whole elements.
+ * */
+void
+getArrayAccessElements(const ArrayRange & arrayRange, Value * pointer, Value * base, uint64_t accessSize,
+		       const DataLayout & dataLayout, const BoundInfo * boundInfo,
+		       uint64_t & firstElement, uint64_t & lastElement, bool & isAligned)
+{
+	double lastIndex = arrayRange.elementNum == 0 ? 0 : arrayRange.elementNum - 1;
+	firstElement	 = 0;
+	lastElement	 = lastIndex;
+	isAligned	 = accessSize == arrayRange.elementSize;
+	std::pair<double, double> offsetRange;
+	if (arrayRange.elementNum == 0 || !getPointerOffsetRange(pointer, base, dataLayout, boundInfo, offsetRange))
+	{
+		return;
+	}
+	isAligned = isAligned && std::fmod(offsetRange.first, arrayRange.elementSize) == 0;
 	/*
-	 * 5. convert binary string to decimal int64_t
+	 * an access out of the bounds is undefined
 	 * */
-	int64_t minRes = convertBin2Dec(minResStr, bitSize);
-	int64_t maxRes = convertBin2Dec(maxResStr, bitSize);
-	return std::make_pair(minRes, maxRes);
+	double firstIndex = std::floor(offsetRange.first / arrayRange.elementSize);
+	double endIndex	  = std::floor((offsetRange.second + accessSize - 1) / arrayRange.elementSize);
+	firstElement	  = max(0.0, min(firstIndex, lastIndex));
+	lastElement	  = max(static_cast<double>(firstElement), min(endIndex, lastIndex));
 }
 
-std::pair<Value *, std::pair<double, double>>
-rangeAnalysis(State * N, llvm::Function & llvmIrFunction, BoundInfo * boundInfo,
-	      std::map<std::string, llvm::CallInst *> &				      callerMap,
-	      const std::map<std::string, std::pair<double, double>> &		      typeRange,
-	      const std::map<llvm::Value *, std::vector<std::pair<double, double>>> & virtualRegisterVectorRange,
-	      bool								      useOverLoad)
+/*
+ * keep the value of a store in the summary of the array it stores to, returns the array if its summary changed
+ * */
+Value *
+storeArrayRange(BoundInfo * boundInfo, StoreInst * llvmIrStoreInstruction, const std::set<BasicBlock *> & visitedBlocks)
 {
-	flexprint(N->Fe, N->Fm, N->Fpinfo, "\tCall: Analyze function %s.\n", llvmIrFunction.getName());
+	const DataLayout & dataLayout = llvmIrStoreInstruction->getModule()->getDataLayout();
+	Value *		   arrayBase  = getUnderlyingObject(llvmIrStoreInstruction->getPointerOperand());
+	ArrayRange *	   arrayRange = getArrayRange(boundInfo, arrayBase, dataLayout);
+	if (arrayRange == nullptr || arrayRange->unknownStores)
+	{
+		return nullptr;
+	}
+	Value *	 storedValue = llvmIrStoreInstruction->getValueOperand();
+	uint64_t firstElement, lastElement;
+	bool	 isAligned;
+	getArrayAccessElements(*arrayRange, llvmIrStoreInstruction->getPointerOperand(), arrayBase,
+			       dataLayout.getTypeStoreSize(storedValue->getType()).getFixedSize(), dataLayout, boundInfo,
+			       firstElement, lastElement, isAligned);
+	std::pair<double, double> valueRange;
+	if (isAligned && getValueRange(storedValue, boundInfo, valueRange))
+	{
+		return joinArrayRange(*arrayRange, firstElement, lastElement, valueRange) ? arrayBase : nullptr;
+	}
 	/*
-	 * information for the union data structure
+	 * a value defined in a block not interpreted yet gets its range later
 	 * */
-	std::map<Value *, Value *> unionAddress;
-	/*
+	auto storedInstruction = dyn_cast<Instruction>(storedValue);
+	if (isAligned && storedInstruction != nullptr && visitedBlocks.find(storedInstruction->getParent()) == visitedBlocks.end())
+	{
+		return nullptr;
+	}
+	arrayRange->unknownStores = true;
+	return arrayBase;
+}
+
+/*
+ * the range a load reads from the summary of an array
+ * */
+bool
+loadArrayRange(const BoundInfo * boundInfo, LoadInst * llvmIrLoadInstruction, std::pair<double, double> & loadRange)
+{
+	const DataLayout & dataLayout = llvmIrLoadInstruction->getModule()->getDataLayout();
+	Value *		   arrayBase  = getUnderlyingObject(llvmIrLoadInstruction->getPointerOperand());
+	auto		   arIt	      = boundInfo->arrayRange.find(arrayBase);
+	if (arIt == boundInfo->arrayRange.end() || arIt->second.unknownInitial || arIt->second.unknownStores)
+	{
+		return false;
+	}
+	const ArrayRange * arrayRange = &arIt->second;
+	uint64_t	   firstElement, lastElement;
+	bool		   isAligned;
+	getArrayAccessElements(*arrayRange, llvmIrLoadInstruction->getPointerOperand(), arrayBase,
+			       dataLayout.getTypeStoreSize(llvmIrLoadInstruction->getType()).getFixedSize(), dataLayout, boundInfo,
+			       firstElement, lastElement, isAligned);
+	return isAligned && getArrayElementsRange(*arrayRange, firstElement, lastElement, loadRange);
+}
+
+/*
+ * the stores of a call to the arrays it gets pointers to, returns the arrays whose summary changed:
+ * 1. a defined callee stores what its summary of the argument holds.
+ * 2. memset() of zero, and memcpy() or memmove() from an array we have a summary of.
+ * 3. other declared functions may store anything, unless they only read the argument.
+ * */
+std::vector<Value *>
+callArrayRange(BoundInfo * boundInfo, CallInst * llvmIrCallInstruction, const BoundInfo * calleeBoundInfo)
+{
+	std::vector<Value *> changedArrays;
+	const DataLayout &   dataLayout	    = llvmIrCallInstruction->getModule()->getDataLayout();
+	Function *	     calledFunction = llvmIrCallInstruction->getCalledFunction();
+	if (llvmIrCallInstruction->isLifetimeStartOrEnd() || isa<DbgInfoIntrinsic>(llvmIrCallInstruction))
+	{
+		return changedArrays;
+	}
+	if (auto memIntrinsic = dyn_cast<MemIntrinsic>(llvmIrCallInstruction))
+	{
+		Value *	     arrayBase	= getUnderlyingObject(memIntrinsic->getDest());
+		ArrayRange * arrayRange = getArrayRange(boundInfo, arrayBase, dataLayout);
+		if (arrayRange == nullptr || arrayRange->unknownStores)
+			return changedArrays;
+		auto			  lengthValue = dyn_cast<ConstantInt>(memIntrinsic->getLength());
+		std::pair<double, double> storedRange;
+		bool			  hasRange = false;
+		if (auto memSet = dyn_cast<MemSetInst>(memIntrinsic))
+		{
+			auto setValue = dyn_cast<ConstantInt>(memSet->getValue());
+			hasRange      = setValue != nullptr && setValue->isZero();
+			storedRange   = std::make_pair(0, 0);
+		}
+		else if (auto memTransfer = dyn_cast<MemTransferInst>(memIntrinsic))
+		{
+			Value *	     sourceBase	       = getUnderlyingObject(memTransfer->getSource());
+			ArrayRange * sourceArrayRange = getArrayRange(boundInfo, sourceBase, dataLayout);
+			if (sourceArrayRange != nullptr && !sourceArrayRange->unknownInitial && !sourceArrayRange->unknownStores &&
+			    sourceArrayRange->elementSize == arrayRange->elementSize)
+			{
+				hasRange = getArrayElementsRange(*sourceArrayRange, 0, sourceArrayRange->segmentRanges.size() * sourceArrayRange->segmentSize,
+								 storedRange);
+			}
+		}
+		uint64_t firstElement, lastElement;
+		bool	 isAligned;
+		getArrayAccessElements(*arrayRange, memIntrinsic->getDest(), arrayBase,
+				       lengthValue == nullptr ? arrayRange->elementSize : lengthValue->getZExtValue(), dataLayout, boundInfo,
+				       firstElement, lastElement, isAligned);
+		if (lengthValue == nullptr)
+		{
+			lastElement = arrayRange->elementNum == 0 ? 0 : arrayRange->elementNum - 1;
+		}
+		if (hasRange)
+		{
+			if (joinArrayRange(*arrayRange, firstElement, lastElement, storedRange))
+				changedArrays.emplace_back(arrayBase);
+		}
+		else
+		{
+			arrayRange->unknownStores = true;
+			changedArrays.emplace_back(arrayBase);
+		}
+		return changedArrays;
+	}
+
+	for (unsigned idx = 0; idx < llvmIrCallInstruction->arg_size(); idx++)
+	{
+		Value * arg = llvmIrCallInstruction->getArgOperand(idx);
+		if (!arg->getType()->isPointerTy())
+			continue;
+		Value *	     arrayBase	= getUnderlyingObject(arg);
+		ArrayRange * arrayRange = getArrayRange(boundInfo, arrayBase, dataLayout);
+		if (arrayRange == nullptr || arrayRange->unknownStores)
+			continue;
+		if (calleeBoundInfo == nullptr || calledFunction == nullptr || idx >= calledFunction->arg_size())
+		{
+			if (llvmIrCallInstruction->onlyReadsMemory(idx))
+				continue;
+			arrayRange->unknownStores = true;
+			changedArrays.emplace_back(arrayBase);
+			continue;
+		}
+		auto arIt = calleeBoundInfo->arrayRange.find(calledFunction->getArg(idx));
+		if (arIt == calleeBoundInfo->arrayRange.end())
+		{
+			/*
+			 * the callee didn't store through it
+			 * */
+			continue;
+		}
+		/*
+		 * the callee doesn't know the size of the array, so what it stored may be anywhere from the argument on
+		 * */
+		std::pair<double, double> storedRange;
+		bool			  hasStored = getArrayElementsRange(arIt->second, 0, 0, storedRange);
+		uint64_t		  firstElement, lastElement;
+		bool			  isAligned;
+		getArrayAccessElements(*arrayRange, arg, arrayBase, arrayRange->elementSize, dataLayout, boundInfo,
+				       firstElement, lastElement, isAligned);
+		lastElement = arrayRange->elementNum == 0 ? 0 : arrayRange->elementNum - 1;
+		if (arIt->second.unknownStores || (hasStored && (!isAligned || arIt->second.elementSize != arrayRange->elementSize)))
+		{
+			arrayRange->unknownStores = true;
+			changedArrays.emplace_back(arrayBase);
+		}
+		else if (hasStored && joinArrayRange(*arrayRange, firstElement, lastElement, storedRange))
+		{
+			changedArrays.emplace_back(arrayBase);
+		}
+	}
+	return changedArrays;
+}
+
+/*
+ * limits of the structure fields
+ * */
+enum FieldRangeLimit {
+	/*
+	 * the nesting of structures, unions and arrays followed in the type of a variable
+	 * */
+	MaxFieldDepth = 8,
+};
+
+/*
+ * the basic type under the typedefs and qualifiers of `fieldType`
+ * */
+const DIBasicType *
+getFieldBasicType(const DIType * fieldType)
+{
+	while (auto derivedType = dyn_cast_or_null<DIDerivedType>(fieldType))
+	{
+		auto typeTag = derivedType->getTag();
+		if (typeTag != dwarf::DW_TAG_typedef && typeTag != dwarf::DW_TAG_const_type &&
+		    typeTag != dwarf::DW_TAG_volatile_type)
+			return nullptr;
+		fieldType = derivedType->getBaseType();
+	}
+	return dyn_cast_or_null<DIBasicType>(fieldType);
+}
+
+/*
+ * record the ranges of the fields of `fieldType` stored at `offsetInBits` from `structAddress`,
+ * for the members whose type is a typedef in `typeRange`, e.g.
+ * typedef struct {
+ *   bmx055xAcceleration x;
+ *   bmx055yAcceleration y;
+ * } accelerometerReading;
+ * The members of a union are all at the offset of the union, so a member
+ * read through a bitcast or a GEP on the union finds the range of its type.
+ * */
+void
+recordFieldRange(const std::map<std::string, std::pair<double, double>> & typeRange, BoundInfo * boundInfo,
+		 Value * structAddress, const DIType * fieldType, uint64_t offsetInBits, unsigned depth)
+{
+	if (fieldType == nullptr || depth > MaxFieldDepth)
+		return;
+
+	if (auto derivedType = dyn_cast<DIDerivedType>(fieldType))
+	{
+		switch (derivedType->getTag())
+		{
+			case dwarf::DW_TAG_member:
+				if (!derivedType->isBitField())
+					recordFieldRange(typeRange, boundInfo, structAddress, derivedType->getBaseType(),
+							 offsetInBits + derivedType->getOffsetInBits(), depth + 1);
+				break;
+			case dwarf::DW_TAG_typedef:
+			{
+				auto typeRangeIt = typeRange.find(derivedType->getName().str());
+				auto basicType	 = getFieldBasicType(derivedType);
+				if (typeRangeIt == typeRange.end() || basicType == nullptr)
+				{
+					recordFieldRange(typeRange, boundInfo, structAddress, derivedType->getBaseType(), offsetInBits, depth + 1);
+					break;
+				}
+				FieldRange fieldRange;
+				fieldRange.fieldSize	   = basicType->getSizeInBits() / 8;
+				fieldRange.isFloatingPoint = basicType->getEncoding() == dwarf::DW_ATE_float;
+				fieldRange.range	   = typeRangeIt->second;
+				auto fieldKey		   = std::make_pair(structAddress, offsetInBits / 8);
+				auto frIt		   = boundInfo->fieldRange.find(fieldKey);
+				if (frIt == boundInfo->fieldRange.end())
+				{
+					boundInfo->fieldRange.emplace(fieldKey, fieldRange);
+				}
+				else if (frIt->second.fieldSize == fieldRange.fieldSize &&
+					 frIt->second.isFloatingPoint == fieldRange.isFloatingPoint)
+				{
+					/*
+					 * two members of a union with sensor types of the same kind
+					 * */
+					frIt->second.range = std::make_pair(min(frIt->second.range.first, fieldRange.range.first),
+									    max(frIt->second.range.second, fieldRange.range.second));
+				}
+				break;
+			}
+			case dwarf::DW_TAG_const_type:
+			case dwarf::DW_TAG_volatile_type:
+				recordFieldRange(typeRange, boundInfo, structAddress, derivedType->getBaseType(), offsetInBits, depth + 1);
+				break;
+			default:
+				/*
+				 * a pointer is another variable
+				 * */
+				break;
+		}
+	}
+	else if (auto compositeType = dyn_cast<DICompositeType>(fieldType))
+	{
+		switch (compositeType->getTag())
+		{
+			case dwarf::DW_TAG_structure_type:
+			case dwarf::DW_TAG_class_type:
+			case dwarf::DW_TAG_union_type:
+				for (auto element : compositeType->getElements())
+				{
+					recordFieldRange(typeRange, boundInfo, structAddress, dyn_cast_or_null<DIType>(element),
+							 offsetInBits, depth + 1);
+				}
+				break;
+			case dwarf::DW_TAG_array_type:
+			{
+				/*
+				 * the elements of a one-dimensional array, up to the number of elements we keep for an array
+				 * */
+				auto elements = compositeType->getElements();
+				if (elements.size() != 1 || compositeType->getBaseType() == nullptr)
+					break;
+				auto subrange = dyn_cast_or_null<DISubrange>(elements[0]);
+				auto count    = subrange == nullptr ? nullptr : subrange->getCount().dyn_cast<ConstantInt *>();
+				if (count == nullptr || count->getSExtValue() <= 0)
+					break;
+				uint64_t elementNum	     = min(static_cast<uint64_t>(count->getSExtValue()), static_cast<uint64_t>(MaxArraySegments));
+				uint64_t elementSizeInBits = compositeType->getSizeInBits() / count->getSExtValue();
+				for (uint64_t idx = 0; idx < elementNum; idx++)
+				{
+					recordFieldRange(typeRange, boundInfo, structAddress, compositeType->getBaseType(),
+							 offsetInBits + idx * elementSizeInBits, depth + 1);
+				}
+				break;
+			}
+			default:
+				break;
+		}
+	}
+}
+
+/*
+ * the range of the field `pointer` points to, if it is a constant offset from a structure with field ranges
+ * */
+bool
+getFieldRange(const BoundInfo * boundInfo, Value * pointer, const DataLayout & dataLayout, std::pair<double, double> & fieldRange)
+{
+	if (boundInfo->fieldRange.empty() || !pointer->getType()->isPointerTy())
+		return false;
+	APInt	fieldOffset(dataLayout.getIndexTypeSizeInBits(pointer->getType()), 0);
+	Value * structAddress = pointer->stripAndAccumulateConstantOffsets(dataLayout, fieldOffset, true);
+	if (fieldOffset.isNegative())
+		return false;
+	auto frIt = boundInfo->fieldRange.find(std::make_pair(structAddress, fieldOffset.getZExtValue()));
+	if (frIt == boundInfo->fieldRange.end())
+		return false;
+	Type * accessType = pointer->getType()->getPointerElementType();
+	if ((!accessType->isFloatingPointTy() && !accessType->isIntegerTy()) ||
+	    accessType->isFloatingPointTy() != frIt->second.isFloatingPoint ||
+	    dataLayout.getTypeStoreSize(accessType).getFixedSize() != frIt->second.fieldSize)
+		return false;
+	fieldRange = frIt->second.range;
+	return true;
+}
+
+/*
+ * the range of the value a load reads:
+ * 1. the join of the stores that reach it in MemorySSA, if they all store to the same address.
+ * 2. the join of the elements it may read, if it reads from an array we keep a summary of.
+ * 3. otherwise, the range of its address, joined with the value of the closest store to an address that may alias.
+ * */
+bool
+getLoadRange(MemorySSA & memorySSA, AAResults & aliasAnalysis,
+	     const std::map<Instruction *, std::pair<double, double>> & loopStoreRanges, const BoundInfo * boundInfo,
+	     LoadInst * llvmIrLoadInstruction, std::pair<double, double> & loadRange)
+{
+	MemoryAccess * loadAccess    = memorySSA.getMemoryAccess(llvmIrLoadInstruction);
+	MemoryAccess * clobberAccess = nullptr;
+	if (loadAccess != nullptr)
+	{
+		clobberAccess = memorySSA.getWalker()->getClobberingMemoryAccess(loadAccess);
+		std::set<MemoryAccess *> visitedAccesses;
+		bool			 hasRange = false;
+		if (joinReachingStoreRanges(memorySSA, aliasAnalysis, loopStoreRanges, boundInfo, llvmIrLoadInstruction,
+					    clobberAccess, visitedAccesses, hasRange, loadRange) &&
+		    hasRange)
+			return true;
+	}
+
+	if (loadArrayRange(boundInfo, llvmIrLoadInstruction, loadRange))
+	{
+		return true;
+	}
+
+	auto vrRangeIt = boundInfo->virtualRegisterRange.find(llvmIrLoadInstruction->getPointerOperand());
+	if (vrRangeIt == boundInfo->virtualRegisterRange.end())
+	{
+		return false;
+	}
+	loadRange			    = vrRangeIt->second;
+	auto			  memoryDef	      = dyn_cast_or_null<MemoryDef>(clobberAccess);
+	auto			  llvmIrStoreInstruction = memoryDef == nullptr ? nullptr : dyn_cast_or_null<StoreInst>(memoryDef->getMemoryInst());
+	std::pair<double, double> storeRange;
+	if (llvmIrStoreInstruction != nullptr &&
+	    llvmIrStoreInstruction->getValueOperand()->getType() == llvmIrLoadInstruction->getType() &&
+	    getValueRange(llvmIrStoreInstruction->getValueOperand(), boundInfo, storeRange))
+	{
+		loadRange = std::make_pair(min(loadRange.first, storeRange.first), max(loadRange.second, storeRange.second));
+	}
+	return true;
+}
+
+/*
+ * the ranges of the two operands of a comparison, an operand without range falls back to the
+ * bound of its type. Fails for pointers and other constants, or if neither operand has a range.
+ * */
+bool
+getCompareOperandRanges(CmpInst * llvmIrCmpInstruction, const BoundInfo * boundInfo,
+			std::pair<double, double> & lhsRange, std::pair<double, double> & rhsRange)
+{
+	bool			  hasRange = false;
+	std::pair<double, double> operandRanges[2];
+	for (unsigned idx = 0; idx < 2; idx++)
+	{
+		Value * operand = llvmIrCmpInstruction->getOperand(idx);
+		if (operand->getType()->isPointerTy() || operand->getType()->isVectorTy())
+		{
+			return false;
+		}
+		if (getValueRange(operand, boundInfo, operandRanges[idx]))
+		{
+			hasRange = true;
+		}
+		else if (isa<llvm::Constant>(operand))
+		{
+			return false;
+		}
+		else
+		{
+			operandRanges[idx] = getTypeBound(operand->getType());
+		}
+	}
+	lhsRange = operandRanges[0];
+	rhsRange = operandRanges[1];
+	return hasRange;
+}
+
+/*
+ * Restrict `lhsRange` and `rhsRange` to the values for which `lhs predicate rhs` can hold,
+ * e.g. `icmp slt %x, 10` restricts %x to [min_x, 9] on the true edge and [10, max_x] on the false one.
+ * Returns false if the predicate holds for none of them.
+ *
+ * Unsigned predicates order the values like the signed ones only if both ranges are non-negative,
+ * otherwise they are left alone. The ranges don't model NaN: an ordered predicate never holds for NaN,
+ * but an unordered one always does, so it is left alone unless `neverNaN` says neither operand is NaN.
+ * */
+bool
+refineRangeByPredicate(CmpInst::Predicate predicate, bool isInteger, bool neverNaN,
+		       std::pair<double, double> & lhsRange, std::pair<double, double> & rhsRange)
+{
+	if (CmpInst::isUnsigned(predicate) && (lhsRange.first < 0 || rhsRange.first < 0))
+	{
+		return true;
+	}
+	if (!isInteger && !neverNaN && CmpInst::isUnordered(predicate))
+	{
+		return true;
+	}
+	/*
+	 * the distance between the two sides of a strict inequality
+	 * */
+	double step = isInteger ? 1 : 0;
+	switch (predicate)
+	{
+		case CmpInst::FCMP_FALSE:
+			return false;
+		case CmpInst::ICMP_EQ:
+		case CmpInst::FCMP_OEQ:
+		case CmpInst::FCMP_UEQ:
+		{
+			double lowerBound = max(lhsRange.first, rhsRange.first);
+			double upperBound = min(lhsRange.second, rhsRange.second);
+			if (lowerBound > upperBound)
+			{
+				return false;
+			}
+			lhsRange = rhsRange = std::make_pair(lowerBound, upperBound);
+			return true;
+		}
+		case CmpInst::ICMP_NE:
+		case CmpInst::FCMP_ONE:
+		case CmpInst::FCMP_UNE:
+			if (lhsRange.first == lhsRange.second && rhsRange.first == rhsRange.second &&
+			    lhsRange.first == rhsRange.first)
+			{
+				return false;
+			}
+			if (isInteger && rhsRange.first == rhsRange.second)
+			{
+				if (lhsRange.first == rhsRange.first)
+				{
+					lhsRange.first += step;
+				}
+				else if (lhsRange.second == rhsRange.first)
+				{
+					lhsRange.second -= step;
+				}
+			}
+			else if (isInteger && lhsRange.first == lhsRange.second)
+			{
+				if (rhsRange.first == lhsRange.first)
+				{
+					rhsRange.first += step;
+				}
+				else if (rhsRange.second == lhsRange.first)
+				{
+					rhsRange.second -= step;
+				}
+			}
+			return true;
+		case CmpInst::ICMP_SLT:
+		case CmpInst::ICMP_ULT:
+		case CmpInst::FCMP_OLT:
+		case CmpInst::FCMP_ULT:
+			if (lhsRange.first >= rhsRange.second)
+			{
+				return false;
+			}
+			lhsRange.second = min(lhsRange.second, rhsRange.second - step);
+			rhsRange.first	= max(rhsRange.first, lhsRange.first + step);
+			return true;
+		case CmpInst::ICMP_SLE:
+		case CmpInst::ICMP_ULE:
+		case CmpInst::FCMP_OLE:
+		case CmpInst::FCMP_ULE:
+			if (lhsRange.first > rhsRange.second)
+			{
+				return false;
+			}
+			lhsRange.second = min(lhsRange.second, rhsRange.second);
+			rhsRange.first	= max(rhsRange.first, lhsRange.first);
+			return true;
+		case CmpInst::ICMP_SGT:
+		case CmpInst::ICMP_UGT:
+		case CmpInst::FCMP_OGT:
+		case CmpInst::FCMP_UGT:
+		case CmpInst::ICMP_SGE:
+		case CmpInst::ICMP_UGE:
+		case CmpInst::FCMP_OGE:
+		case CmpInst::FCMP_UGE:
+			return refineRangeByPredicate(CmpInst::getSwappedPredicate(predicate), isInteger, neverNaN, rhsRange, lhsRange);
+		default:
+			return true;
+	}
+}
+
+/*
+ * The ranges of the values compared by `condition` when it evaluates to `isTrue`,
+ * including the condition itself. Returns false if it can never evaluate to `isTrue`.
+ * */
+bool
+getConditionRanges(Value * condition, bool isTrue, const BoundInfo * boundInfo,
+		   std::map<Value *, std::pair<double, double>> & conditionRanges)
+{
+	if (auto constCondition = dyn_cast<ConstantInt>(condition))
+	{
+		return constCondition->isOne() == isTrue;
+	}
+	conditionRanges.emplace(condition, isTrue ? std::make_pair(1, 1) : std::make_pair(0, 0));
+	auto llvmIrCmpInstruction = dyn_cast<CmpInst>(condition);
+	if (llvmIrCmpInstruction == nullptr)
+	{
+		return true;
+	}
+	std::pair<double, double> lhsRange, rhsRange;
+	if (!getCompareOperandRanges(llvmIrCmpInstruction, boundInfo, lhsRange, rhsRange))
+	{
+		return true;
+	}
+	auto predicate = isTrue ? llvmIrCmpInstruction->getPredicate() : llvmIrCmpInstruction->getInversePredicate();
+	bool neverNaN  = isKnownNeverNaN(llvmIrCmpInstruction->getOperand(0), nullptr) &&
+			isKnownNeverNaN(llvmIrCmpInstruction->getOperand(1), nullptr);
+	if (!refineRangeByPredicate(predicate, llvmIrCmpInstruction->getOperand(0)->getType()->isIntegerTy(), neverNaN,
+				    lhsRange, rhsRange))
+	{
+		return false;
+	}
+	if (!isa<llvm::Constant>(llvmIrCmpInstruction->getOperand(0)))
+	{
+		conditionRanges[llvmIrCmpInstruction->getOperand(0)] = lhsRange;
+	}
+	if (!isa<llvm::Constant>(llvmIrCmpInstruction->getOperand(1)))
+	{
+		conditionRanges[llvmIrCmpInstruction->getOperand(1)] = rhsRange;
+	}
+	return true;
+}
+
+/*
+ * limits of the difference-bound domain
+ * */
+enum DifferenceBoundLimit {
+	/*
+	 * the values related to the operands of a comparison, the closure is cubic in their number
+	 * */
+	MaxRelatedValues = 16,
+};
+
+/*
+ * `lhs - rhs <= upperBound`
+ * */
+typedef struct DifferenceBound {
+	Value * lhs;
+	Value * rhs;
+	double	upperBound;
+} DifferenceBound;
+
+/*
+ * whether the comparisons of the function are also decided with the difference bounds, by --llvm-ir-relational
+ * */
+bool
+isRelationalDomainEnabled(State * N, Function & llvmIrFunction)
+{
+	if (N->llvmIRRelationalFunctions == nullptr)
+	{
+		return false;
+	}
+	StringRef relationalFunctions(N->llvmIRRelationalFunctions);
+	if (relationalFunctions == "all")
+	{
+		return true;
+	}
+	SmallVector<StringRef, 8> functionNames;
+	relationalFunctions.split(functionNames, ',', -1, false);
+	return is_contained(functionNames, llvmIrFunction.getName());
+}
+
+/*
+ * the difference bounds `value` is defined with, e.g. `%y = sub nsw i32 %x, %offset` bounds `%y - %x` by the range of %offset.
+ * The floating-point arithmetic rounds, so it only gives the order of the values.
+ * */
+void
+getDefinitionBounds(Value * value, const BoundInfo * boundInfo, std::vector<DifferenceBound> & differenceBounds)
+{
+	auto llvmIrInstruction = dyn_cast<Instruction>(value);
+	if (llvmIrInstruction == nullptr)
+	{
+		return;
+	}
+	bool isInteger = llvmIrInstruction->getType()->isIntegerTy();
+	/*
+	 * `value - base` is in `offsetRange`
+	 * */
+	auto addBounds = [&](Value * base, std::pair<double, double> offsetRange) {
+		if (isInteger)
+		{
+			differenceBounds.push_back({value, base, offsetRange.second});
+			differenceBounds.push_back({base, value, -offsetRange.first});
+			return;
+		}
+		if (offsetRange.second <= 0)
+			differenceBounds.push_back({value, base, 0});
+		if (offsetRange.first >= 0)
+			differenceBounds.push_back({base, value, 0});
+	};
+
+	std::pair<double, double> operandRanges[2];
+	switch (llvmIrInstruction->getOpcode())
+	{
+		case Instruction::Add:
+		case Instruction::Sub:
+			if (!llvmIrInstruction->hasNoSignedWrap())
+				break;
+			LLVM_FALLTHROUGH;
+		case Instruction::FAdd:
+		case Instruction::FSub:
+		{
+			bool isSub	    = llvmIrInstruction->getOpcode() == Instruction::Sub || llvmIrInstruction->getOpcode() == Instruction::FSub;
+			bool hasLhsRange = getValueRange(llvmIrInstruction->getOperand(0), boundInfo, operandRanges[0]);
+			bool hasRhsRange = getValueRange(llvmIrInstruction->getOperand(1), boundInfo, operandRanges[1]);
+			if (hasRhsRange)
+			{
+				addBounds(llvmIrInstruction->getOperand(0),
+					  isSub ? std::make_pair(-operandRanges[1].second, -operandRanges[1].first) : operandRanges[1]);
+			}
+			if (hasLhsRange && !isSub)
+			{
+				addBounds(llvmIrInstruction->getOperand(1), operandRanges[0]);
+			}
+			break;
+		}
+		case Instruction::SExt:
+		case Instruction::FPExt:
+			addBounds(llvmIrInstruction->getOperand(0), std::make_pair(0, 0));
+			break;
+		default:
+			break;
+	}
+}
+
+/*
+ * the difference bounds given by the branches into the dominators of `block`,
+ * e.g. `br i1 (icmp slt %i, %n), label %body, ...` bounds `%i - %n` by -1 in %body
+ * */
+void
+getBranchBounds(BasicBlock * block, const BoundInfo * boundInfo, const DominatorTree & dominatorTree,
+		std::vector<DifferenceBound> & differenceBounds)
+{
+	for (auto domNode = dominatorTree.getNode(block); domNode != nullptr; domNode = domNode->getIDom())
+	{
+		BasicBlock * predecessor = domNode->getBlock()->getUniquePredecessor();
+		auto	     llvmIrBrInstruction = predecessor == nullptr ? nullptr : dyn_cast<BranchInst>(predecessor->getTerminator());
+		if (llvmIrBrInstruction == nullptr || !llvmIrBrInstruction->isConditional() ||
+		    llvmIrBrInstruction->getSuccessor(0) == llvmIrBrInstruction->getSuccessor(1))
+			continue;
+		auto llvmIrCmpInstruction = dyn_cast<CmpInst>(llvmIrBrInstruction->getCondition());
+		if (llvmIrCmpInstruction == nullptr)
+			continue;
+		Value * lhs	  = llvmIrCmpInstruction->getOperand(0);
+		Value * rhs	  = llvmIrCmpInstruction->getOperand(1);
+		bool	isInteger = lhs->getType()->isIntegerTy();
+		if (!isInteger && !lhs->getType()->isFloatingPointTy())
+			continue;
+		auto predicate = llvmIrBrInstruction->getSuccessor(0) == domNode->getBlock() ? llvmIrCmpInstruction->getPredicate()
+											      : llvmIrCmpInstruction->getInversePredicate();
+		/*
+		 * an unordered predicate also holds if an operand is NaN, e.g. on the false edge of `fcmp olt`,
+		 * so it only orders the values that are never NaN
+		 * */
+		if (!isInteger && CmpInst::isUnordered(predicate) &&
+		    (!isKnownNeverNaN(lhs, nullptr) || !isKnownNeverNaN(rhs, nullptr)))
+			continue;
+		if (CmpInst::isUnsigned(predicate))
+		{
+			/*
+			 * unsigned predicates order the values like the signed ones only if both are non-negative
+			 * */
+			std::pair<double, double> lhsRange, rhsRange;
+			if (!getValueRange(lhs, boundInfo, lhsRange) || !getValueRange(rhs, boundInfo, rhsRange) ||
+			    lhsRange.first < 0 || rhsRange.first < 0)
+				continue;
+			predicate = ICmpInst::getSignedPredicate(predicate);
+		}
+		double step = isInteger ? 1 : 0;
+		switch (predicate)
+		{
+			case CmpInst::ICMP_EQ:
+			case CmpInst::FCMP_OEQ:
+			case CmpInst::FCMP_UEQ:
+				differenceBounds.push_back({lhs, rhs, 0});
+				differenceBounds.push_back({rhs, lhs, 0});
+				break;
+			case CmpInst::ICMP_SLT:
+			case CmpInst::FCMP_OLT:
+			case CmpInst::FCMP_ULT:
+				differenceBounds.push_back({lhs, rhs, -step});
+				break;
+			case CmpInst::ICMP_SLE:
+			case CmpInst::FCMP_OLE:
+			case CmpInst::FCMP_ULE:
+				differenceBounds.push_back({lhs, rhs, 0});
+				break;
+			case CmpInst::ICMP_SGT:
+			case CmpInst::FCMP_OGT:
+			case CmpInst::FCMP_UGT:
+				differenceBounds.push_back({rhs, lhs, -step});
+				break;
+			case CmpInst::ICMP_SGE:
+			case CmpInst::FCMP_OGE:
+			case CmpInst::FCMP_UGE:
+				differenceBounds.push_back({rhs, lhs, 0});
+				break;
+			default:
+				break;
+		}
+	}
+}
+
+/*
+ * The range of `lhs - rhs` of a comparison, from the closure of the difference bounds between the values related to its operands.
+ * The values are related by their definitions and by the branches into the block of the comparison,
+ * and the ranges of the values bound their difference to a value standing for 0.
+ * Fails if nothing relates the values, or if the bounds contradict each other.
+ * */
+bool
+getDifferenceRange(CmpInst * llvmIrCmpInstruction, const BoundInfo * boundInfo, const DominatorTree & dominatorTree,
+		   std::pair<double, double> & differenceRange)
+{
+	std::vector<DifferenceBound> branchBounds;
+	getBranchBounds(llvmIrCmpInstruction->getParent(), boundInfo, dominatorTree, branchBounds);
+
+	/*
+	 * the related values, by breadth-first search from the operands
+	 * */
+	std::vector<Value *>	     relatedValues = {nullptr};
+	std::map<Value *, size_t>    valueIndex;
+	std::vector<DifferenceBound> differenceBounds;
+	for (unsigned idx = 0; idx < 2; idx++)
+	{
+		if (valueIndex.emplace(llvmIrCmpInstruction->getOperand(idx), relatedValues.size()).second)
+			relatedValues.emplace_back(llvmIrCmpInstruction->getOperand(idx));
+	}
+	for (size_t idx = 1; idx < relatedValues.size(); idx++)
+	{
+		size_t firstBound = differenceBounds.size();
+		getDefinitionBounds(relatedValues[idx], boundInfo, differenceBounds);
+		for (const auto & branchBound : branchBounds)
+		{
+			if (branchBound.lhs == relatedValues[idx] || branchBound.rhs == relatedValues[idx])
+				differenceBounds.emplace_back(branchBound);
+		}
+		for (size_t boundIdx = firstBound; boundIdx < differenceBounds.size(); boundIdx++)
+		{
+			for (Value * boundValue : {differenceBounds[boundIdx].lhs, differenceBounds[boundIdx].rhs})
+			{
+				if (relatedValues.size() < MaxRelatedValues && valueIndex.emplace(boundValue, relatedValues.size()).second)
+					relatedValues.emplace_back(boundValue);
+			}
+		}
+	}
+	if (differenceBounds.empty())
+	{
+		return false;
+	}
+
+	/*
+	 * `bounds[i][j]` bounds `relatedValues[i] - relatedValues[j]`, the value at 0 stands for 0
+	 * */
+	size_t				 valueNum = relatedValues.size();
+	double				 infinity = std::numeric_limits<double>::infinity();
+	std::vector<std::vector<double>> bounds(valueNum, std::vector<double>(valueNum, infinity));
+	for (size_t idx = 0; idx < valueNum; idx++)
+	{
+		bounds[idx][idx] = 0;
+		std::pair<double, double> valueRange;
+		if (idx > 0 && getValueRange(relatedValues[idx], boundInfo, valueRange))
+		{
+			bounds[idx][0] = valueRange.second;
+			bounds[0][idx] = -valueRange.first;
+		}
+	}
+	for (const auto & differenceBound : differenceBounds)
+	{
+		auto lhsIt = valueIndex.find(differenceBound.lhs);
+		auto rhsIt = valueIndex.find(differenceBound.rhs);
+		if (lhsIt != valueIndex.end() && rhsIt != valueIndex.end())
+			bounds[lhsIt->second][rhsIt->second] = min(bounds[lhsIt->second][rhsIt->second], differenceBound.upperBound);
+	}
+	for (size_t mid = 0; mid < valueNum; mid++)
+	{
+		for (size_t from = 0; from < valueNum; from++)
+		{
+			for (size_t to = 0; to < valueNum; to++)
+			{
+				if (bounds[from][mid] + bounds[mid][to] < bounds[from][to])
+					bounds[from][to] = bounds[from][mid] + bounds[mid][to];
+			}
+		}
+	}
+	for (size_t idx = 0; idx < valueNum; idx++)
+	{
+		/*
+		 * the bounds contradict each other, e.g. in a block that is never reached
+		 * */
+		if (bounds[idx][idx] < 0)
+			return false;
+	}
+	size_t rhsIndex = valueIndex[llvmIrCmpInstruction->getOperand(1)];
+	differenceRange = std::make_pair(-bounds[rhsIndex][1], bounds[1][rhsIndex]);
+	return true;
+}
+
+std::pair<Value *, std::pair<double, double>>
+rangeAnalysis(State * N, llvm::Function & llvmIrFunction, BoundInfo * boundInfo,
+	      std::map<std::string, llvm::CallInst *> &				      callerMap,
+	      const std::map<std::string, std::pair<double, double>> &		      typeRange,
+	      const std::map<llvm::Value *, std::vector<std::pair<double, double>>> & virtualRegisterVectorRange,
+	      bool								      useOverLoad)
+{
+	flexprint(N->Fe, N->Fm, N->Fpinfo, "\tCall: Analyze function %s.\n", llvmIrFunction.getName());
+	if (llvmIrFunction.isDeclaration())
+	{
+		return {nullptr, {}};
+	}
+	/*
+	 * information for the union data structure
+	 * */
+	std::map<Value *, Value *> unionAddress;
+	/*
 	 * function arguments
 	 * */
 	std::map<Value *, Value *> storeParamMap;
-	for (BasicBlock & llvmIrBasicBlock : llvmIrFunction)
+
+	boundInfo->virtualRegisterRange.reserve(llvmIrFunction.getInstructionCount() + llvmIrFunction.arg_size());
+
+	/*
+	 * The function body is interpreted until the ranges reach a fixpoint,
+	 * so that loop-carried PHIs and stores in loops converge:
+	 * 1. number the blocks in reverse post-order (unreachable blocks last, in layout order),
+	 *    the worklist always pops the lowest number, so the body of a loop is finished
+	 *    before the blocks after it are revisited.
+	 * 2. if the range written by an instruction changes, re-queue the blocks of its users.
+	 * 3. at a loop header, and for a store inside a loop, a range that still grows after
+	 *    `WideningDelay` visits is widened to the bound of its type.
+	 * 4. if anything was widened, interpret the function again (at most `NarrowingVisits`
+	 *    per block) and narrow the widened ranges with the recomputed ones.
+	 * 5. a conditional branch restricts the values it compares on each outgoing edge.
+	 *    The restriction holds in every block dominated by a successor that is only entered
+	 *    through that edge, and is swapped into `boundInfo` while such a block is interpreted.
+	 * 6. if enabled for the function, a comparison the intervals can't decide is tried with the
+	 *    difference bounds between its operands.
+	 * */
+	DominatorTree			      dominatorTree(llvmIrFunction);
+	LoopInfo			      loopInfo(dominatorTree);
+	bool				      useRelationalDomain = isRelationalDomainEnabled(N, llvmIrFunction);
+	/*
+	 * a load reads the stores that reach it in MemorySSA, and a store re-queues the loads that may alias it
+	 * */
+	TargetLibraryInfoImpl targetLibraryInfoImpl(Triple(llvmIrFunction.getParent()->getTargetTriple()));
+	TargetLibraryInfo     targetLibraryInfo(targetLibraryInfoImpl);
+	AssumptionCache	      assumptionCache(llvmIrFunction);
+	BasicAAResult	      basicAliasAnalysis(llvmIrFunction.getParent()->getDataLayout(), llvmIrFunction,
+						 targetLibraryInfo, assumptionCache, &dominatorTree);
+	AAResults	      aliasAnalysis(targetLibraryInfo);
+	aliasAnalysis.addAAResult(basicAliasAnalysis);
+	MemorySSA	      memorySSA(llvmIrFunction, &aliasAnalysis, &dominatorTree);
+	std::vector<LoadInst *> functionLoads;
+	for (Instruction & llvmIrInstruction : instructions(llvmIrFunction))
+	{
+		if (auto llvmIrLoadInstruction = dyn_cast<LoadInst>(&llvmIrInstruction))
+			functionLoads.emplace_back(llvmIrLoadInstruction);
+	}
+	/*
+	 * the summaries of the arrays the function reads or writes, with the elements of the constant ones
+	 * */
+	for (Instruction & llvmIrInstruction : instructions(llvmIrFunction))
+	{
+		for (Value * operand : llvmIrInstruction.operands())
+		{
+			if (operand->getType()->isPointerTy() && (isa<LoadInst>(llvmIrInstruction) || isa<StoreInst>(llvmIrInstruction) ||
+								  isa<CallInst>(llvmIrInstruction)))
+				getArrayRange(boundInfo, getUnderlyingObject(operand), llvmIrFunction.getParent()->getDataLayout());
+		}
+	}
+	ReversePostOrderTraversal<Function *> rpoTraversal(&llvmIrFunction);
+	std::vector<BasicBlock *>	      blockOrder;
+	std::map<BasicBlock *, size_t>	      blockIndex;
+	for (BasicBlock * rpoBlock : rpoTraversal)
+	{
+		blockIndex.emplace(rpoBlock, blockOrder.size());
+		blockOrder.emplace_back(rpoBlock);
+	}
+	for (BasicBlock & layoutBlock : llvmIrFunction)
+	{
+		if (blockIndex.emplace(&layoutBlock, blockOrder.size()).second)
+		{
+			blockOrder.emplace_back(&layoutBlock);
+		}
+	}
+	std::set<size_t> worklist;
+	for (size_t idx = 0; idx < blockOrder.size(); idx++)
+	{
+		worklist.emplace(idx);
+	}
+	std::map<BasicBlock *, uint32_t>					  blockVisits;
+	std::set<BasicBlock *>							  visitedBlocks;
+	std::map<Instruction *, std::vector<std::pair<bool, std::pair<double, double>>>> callArgRanges;
+	std::map<Instruction *, std::pair<double, double>>			  returnRanges;
+	std::map<Instruction *, std::pair<double, double>>			  loopStoreRanges;
+	bool									  widened   = false;
+	bool									  narrowing = false;
+	std::map<std::pair<BasicBlock *, BasicBlock *>, std::map<Value *, std::pair<double, double>>> edgeRanges;
+
+	/*
+	 * the loads from an array whose summary changed
+	 * */
+	auto enqueueArrayLoads = [&](Value * arrayBase) {
+		for (LoadInst * llvmIrLoadInstruction : functionLoads)
+		{
+			if (getUnderlyingObject(llvmIrLoadInstruction->getPointerOperand()) == arrayBase)
+				worklist.emplace(blockIndex[llvmIrLoadInstruction->getParent()]);
+		}
+	};
+
+	/*
+	 * the loads that may read what a store writes, even through another address
+	 * */
+	auto enqueueAliasingLoads = [&](StoreInst * llvmIrStoreInstruction) {
+		MemoryLocation storeLocation = MemoryLocation::get(llvmIrStoreInstruction);
+		for (LoadInst * llvmIrLoadInstruction : functionLoads)
+		{
+			if (aliasAnalysis.alias(storeLocation, MemoryLocation::get(llvmIrLoadInstruction)) != AliasResult::NoAlias)
+				worklist.emplace(blockIndex[llvmIrLoadInstruction->getParent()]);
+		}
+	};
+
+	auto enqueueUsers = [&](Value * value, Instruction * writer) {
+		for (User * user : value->users())
+		{
+			auto userInstruction = dyn_cast<Instruction>(user);
+			if (userInstruction == nullptr || userInstruction->getParent() == nullptr ||
+			    userInstruction->getFunction() != &llvmIrFunction)
+				continue;
+			/*
+			 * users later in the same block are interpreted in this visit anyway
+			 * */
+			if (userInstruction->getParent() == writer->getParent() && writer->comesBefore(userInstruction))
+				continue;
+			/*
+			 * a store to the address only overwrites it
+			 * */
+			auto userStoreInstruction = dyn_cast<StoreInst>(userInstruction);
+			if (userStoreInstruction != nullptr && userStoreInstruction->getPointerOperand() == value &&
+			    userStoreInstruction->getValueOperand() != value)
+				continue;
+			worklist.emplace(blockIndex[userInstruction->getParent()]);
+		}
+		auto llvmIrStoreInstruction = dyn_cast<StoreInst>(writer);
+		if (llvmIrStoreInstruction != nullptr && llvmIrStoreInstruction->getPointerOperand() == value)
+		{
+			enqueueAliasingLoads(llvmIrStoreInstruction);
+		}
+	};
+
+	/*
+	 * the ranges the edges into the dominators of a block restrict the values to
+	 * */
+	auto getBlockRanges = [&](BasicBlock * block) {
+		std::map<Value *, std::pair<double, double>> blockRanges;
+		for (auto domNode = dominatorTree.getNode(block); domNode != nullptr; domNode = domNode->getIDom())
+		{
+			BasicBlock * predecessor = domNode->getBlock()->getUniquePredecessor();
+			if (predecessor == nullptr)
+				continue;
+			auto erIt = edgeRanges.find(std::make_pair(predecessor, domNode->getBlock()));
+			if (erIt == edgeRanges.end())
+				continue;
+			for (const auto & edgeRange : erIt->second)
+			{
+				auto brIt = blockRanges.find(edgeRange.first);
+				if (brIt == blockRanges.end())
+				{
+					blockRanges.emplace(edgeRange);
+				}
+				else if (max(brIt->second.first, edgeRange.second.first) <= min(brIt->second.second, edgeRange.second.second))
+				{
+					brIt->second = std::make_pair(max(brIt->second.first, edgeRange.second.first),
+								      min(brIt->second.second, edgeRange.second.second));
+				}
+			}
+		}
+		return blockRanges;
+	};
+
+	/*
+	 * if the restriction of an edge changed, re-queue the users it applies to
+	 * */
+	auto updateEdgeRanges = [&](BasicBlock * from, BasicBlock * to, const std::map<Value *, std::pair<double, double>> & ranges) {
+		auto & cachedRanges = edgeRanges[std::make_pair(from, to)];
+		if (cachedRanges == ranges)
+			return;
+		std::set<Value *> restrictedValues;
+		for (const auto & cachedRange : cachedRanges)
+			restrictedValues.emplace(cachedRange.first);
+		for (const auto & range : ranges)
+			restrictedValues.emplace(range.first);
+		cachedRanges = ranges;
+		for (Value * restrictedValue : restrictedValues)
+		{
+			for (User * user : restrictedValue->users())
+			{
+				auto userInstruction = dyn_cast<Instruction>(user);
+				if (userInstruction == nullptr || userInstruction->getParent() == nullptr ||
+				    userInstruction->getFunction() != &llvmIrFunction)
+					continue;
+				BasicBlock * userBlock = userInstruction->getParent();
+				bool	     isRestricted = dominatorTree.dominates(to, userBlock);
+				if (auto userPhi = dyn_cast<PHINode>(userInstruction))
+				{
+					isRestricted = false;
+					for (size_t idx = 0; idx < userPhi->getNumIncomingValues(); idx++)
+					{
+						BasicBlock * incomingBlock = userPhi->getIncomingBlock(idx);
+						if (userPhi->getIncomingValue(idx) == restrictedValue &&
+						    ((incomingBlock == from && userBlock == to) || dominatorTree.dominates(to, incomingBlock)))
+							isRestricted = true;
+					}
+				}
+				if (isRestricted)
+					worklist.emplace(blockIndex[userBlock]);
+			}
+		}
+	};
+
+	/*
+	 * a block that hit `MaxBlockVisits` didn't converge: the values it defines or stores,
+	 * and everything computed from them, go to the bound of their types,
+	 * and its branch no longer restricts the values on its edges
+	 * */
+	auto setToTypeBound = [&](BasicBlock * block) {
+		std::vector<Value *> pendingValues;
+		std::set<Value *>    boundValues;
+		for (Instruction & llvmIrInstruction : *block)
+		{
+			pendingValues.emplace_back(&llvmIrInstruction);
+		}
+		while (!pendingValues.empty())
+		{
+			Value * value = pendingValues.back();
+			pendingValues.pop_back();
+			if (!boundValues.emplace(value).second)
+				continue;
+			Type * valueType = value->getType()->isPointerTy() ? value->getType()->getPointerElementType() : value->getType();
+			if (valueType->isIntegerTy() || valueType->isFloatingPointTy())
+				boundInfo->virtualRegisterRange[value] = getTypeBound(value->getType());
+			else
+				boundInfo->virtualRegisterRange.erase(value);
+
+			std::vector<Value *> writtenAddresses;
+			if (auto llvmIrReturnInstruction = dyn_cast<ReturnInst>(value))
+			{
+				if (llvmIrReturnInstruction->getNumOperands() != 0)
+					returnRanges[llvmIrReturnInstruction] = getTypeBound(llvmIrReturnInstruction->getOperand(0)->getType());
+			}
+			else if (auto llvmIrStoreInstruction = dyn_cast<StoreInst>(value))
+			{
+				auto lsIt = loopStoreRanges.find(llvmIrStoreInstruction);
+				if (lsIt != loopStoreRanges.end())
+					lsIt->second = getTypeBound(llvmIrStoreInstruction->getValueOperand()->getType());
+				writtenAddresses.emplace_back(llvmIrStoreInstruction->getPointerOperand());
+				for (LoadInst * llvmIrLoadInstruction : functionLoads)
+				{
+					if (aliasAnalysis.alias(MemoryLocation::get(llvmIrStoreInstruction),
+								MemoryLocation::get(llvmIrLoadInstruction)) != AliasResult::NoAlias)
+						pendingValues.emplace_back(llvmIrLoadInstruction);
+				}
+			}
+			else if (auto llvmIrCallInstruction = dyn_cast<CallInst>(value))
+			{
+				for (auto & arg : llvmIrCallInstruction->args())
+				{
+					if (arg->getType()->isPointerTy() && !llvmIrCallInstruction->onlyReadsMemory(arg.getOperandNo()))
+						writtenAddresses.emplace_back(arg.get());
+				}
+			}
+			for (Value * writtenAddress : writtenAddresses)
+			{
+				pendingValues.emplace_back(writtenAddress);
+				auto arIt = boundInfo->arrayRange.find(getUnderlyingObject(writtenAddress));
+				if (arIt != boundInfo->arrayRange.end() && !arIt->second.unknownStores)
+				{
+					arIt->second.unknownStores = true;
+					for (LoadInst * llvmIrLoadInstruction : functionLoads)
+					{
+						if (getUnderlyingObject(llvmIrLoadInstruction->getPointerOperand()) == arIt->first)
+							pendingValues.emplace_back(llvmIrLoadInstruction);
+					}
+				}
+			}
+			for (User * user : value->users())
+			{
+				auto userInstruction = dyn_cast<Instruction>(user);
+				if (userInstruction == nullptr || userInstruction->getParent() == nullptr ||
+				    userInstruction->getFunction() != &llvmIrFunction)
+					continue;
+				/*
+				 * a store to the address only overwrites it
+				 * */
+				auto userStoreInstruction = dyn_cast<StoreInst>(userInstruction);
+				if (userStoreInstruction != nullptr && userStoreInstruction->getPointerOperand() == value &&
+				    userStoreInstruction->getValueOperand() != value)
+					continue;
+				pendingValues.emplace_back(userInstruction);
+			}
+		}
+		for (BasicBlock * successor : successors(block))
+		{
+			updateEdgeRanges(block, successor, {});
+		}
+	};
+
+	while (!worklist.empty() || (widened && !narrowing))
 	{
+		if (worklist.empty())
+		{
+			narrowing = true;
+			blockVisits.clear();
+			for (size_t idx = 0; idx < blockOrder.size(); idx++)
+			{
+				worklist.emplace(idx);
+			}
+		}
+		BasicBlock & llvmIrBasicBlock = *blockOrder[*worklist.begin()];
+		worklist.erase(worklist.begin());
+		uint32_t visits = ++blockVisits[&llvmIrBasicBlock];
+		if (visits > (narrowing ? NarrowingVisits : MaxBlockVisits))
+		{
+			/*
+			 * narrowing only tightens ranges that already hold, so it may stop anywhere
+			 * */
+			if (!narrowing)
+				setToTypeBound(&llvmIrBasicBlock);
+			continue;
+		}
+		bool isLoopHeader = loopInfo.isLoopHeader(&llvmIrBasicBlock);
+		bool isInLoop	  = loopInfo.getLoopFor(&llvmIrBasicBlock) != nullptr;
+
+		std::vector<std::pair<Value *, std::pair<bool, std::pair<double, double>>>> unrestrictedRanges;
+		for (const auto & blockRange : getBlockRanges(&llvmIrBasicBlock))
+		{
+			auto vrRangeIt = boundInfo->virtualRegisterRange.find(blockRange.first);
+			if (vrRangeIt != boundInfo->virtualRegisterRange.end())
+			{
+				unrestrictedRanges.emplace_back(blockRange.first, std::make_pair(true, vrRangeIt->second));
+				vrRangeIt->second = blockRange.second;
+			}
+			else
+			{
+				unrestrictedRanges.emplace_back(blockRange.first, std::make_pair(false, std::make_pair(0, 0)));
+				boundInfo->virtualRegisterRange.emplace(blockRange);
+			}
+		}
+
 		for (Instruction & llvmIrInstruction : llvmIrBasicBlock)
 		{
+			/*
+			 * a call is only interpreted again if the ranges of its arguments changed,
+			 * otherwise the callee would be re-analyzed (and re-cloned) on every visit
+			 * */
+			if (auto llvmIrCallInstruction = dyn_cast<CallInst>(&llvmIrInstruction))
+			{
+				auto argRanges = getCallArgRanges(llvmIrCallInstruction, boundInfo);
+				auto caIt      = callArgRanges.find(&llvmIrInstruction);
+				if (caIt != callArgRanges.end() && caIt->second == argRanges)
+				{
+					continue;
+				}
+				callArgRanges[&llvmIrInstruction] = argRanges;
+			}
+
+			/*
+			 * the values whose range this instruction writes: itself, the address of a store,
+			 * and the pointer arguments of a call
+			 * */
+			std::vector<Value *> writtenValues{&llvmIrInstruction};
+			if (auto llvmIrStoreInstruction = dyn_cast<StoreInst>(&llvmIrInstruction))
+			{
+				writtenValues.emplace_back(llvmIrStoreInstruction->getPointerOperand());
+			}
+			else if (auto llvmIrCallInstruction = dyn_cast<CallInst>(&llvmIrInstruction))
+			{
+				for (auto & arg : llvmIrCallInstruction->args())
+				{
+					if (arg->getType()->isPointerTy())
+						writtenValues.emplace_back(arg.get());
+				}
+			}
+			std::vector<std::pair<bool, std::pair<double, double>>> oldRanges;
+			for (auto writtenValue : writtenValues)
+			{
+				auto vrRangeIt = boundInfo->virtualRegisterRange.find(writtenValue);
+				if (vrRangeIt != boundInfo->virtualRegisterRange.end())
+				{
+					oldRanges.emplace_back(true, vrRangeIt->second);
+				}
+				else
+				{
+					oldRanges.emplace_back(false, std::make_pair(0, 0));
+				}
+			}
+			/*
+			 * the handlers below `emplace` the result, so drop the result of the last visit first
+			 * */
+			boundInfo->virtualRegisterRange.erase(&llvmIrInstruction);
+
 			switch (llvmIrInstruction.getOpcode())
 			{
 				case Instruction::Call:
@@ -1048,7 +2418,7 @@ rangeAnalysis(State * N, llvm::Function & llvmIrFunction, BoundInfo * boundInfo,
 								}
 								else if (typeTag == dwarf::DW_TAG_structure_type)
 								{
-									flexprint(N->Fe, N->Fm, N->Fperr, "\tTODO: Call: didn't support structure\n");
+									flexprint(N->Fe, N->Fm, N->Fpinfo, "\tCall: DW_TAG_structure_type\n");
 								}
 								else if (typeTag == dwarf::DW_TAG_array_type)
 								{
@@ -1062,6 +2432,25 @@ rangeAnalysis(State * N, llvm::Function & llvmIrFunction, BoundInfo * boundInfo,
 								}
 							}
 							recordType(variableType);
+
+							/*
+							 * the fields of a structure or union: `llvm.dbg.declare` gives the address of the variable,
+							 * `llvm.dbg.value` gives the address if the variable is a pointer to it.
+							 * */
+							const DIType * structType = nullptr;
+							if (calledFunction->getName().startswith("llvm.dbg.declare"))
+							{
+								structType = variableType;
+							}
+							else if (isa<DIDerivedType>(variableType) && variableType->getTag() == dwarf::DW_TAG_pointer_type &&
+								 localVariableAddress->getType()->isPointerTy())
+							{
+								structType = cast<DIDerivedType>(variableType)->getBaseType();
+							}
+							if (structType != nullptr)
+							{
+								recordFieldRange(typeRange, boundInfo, localVariableAddress, structType, 0, 0);
+							}
 						}
 						/*
 						 * It's function defined by programmer, eg. %17 = call i32 @abstop12(float %16), !dbg !83
@@ -1072,7 +2461,7 @@ rangeAnalysis(State * N, llvm::Function & llvmIrFunction, BoundInfo * boundInfo,
 							{
 								flexprint(N->Fe, N->Fm, N->Fperr, "\tCall: CalledFunction %s is nullptr or undeclared.\n",
 									  calledFunction->getName().str().c_str());
-								continue;
+								break;
 							}
 							else if (calledFunction->isDeclaration())
 							{
@@ -1192,6 +2581,16 @@ rangeAnalysis(State * N, llvm::Function & llvmIrFunction, BoundInfo * boundInfo,
 								std::string newFuncName = calledFunction->getName().str();
 								auto innerBoundInfo   = new BoundInfo();
 								bool hasSpecificRange = false;
+								/*
+								 * the callee shares the ranges of the global variables and the summaries with the caller
+								 * */
+								innerBoundInfo->virtualRegisterRange.shareGlobalRanges(boundInfo->virtualRegisterRange.getGlobalRanges());
+								innerBoundInfo->calleeSummary = boundInfo->calleeSummary;
+								innerBoundInfo->specialization = boundInfo->specialization;
+								/*
+								 * the context of the callee: the range of each argument, or an empty range if it has none
+								 * */
+								CalleeContext calleeContext(calledFunction, {});
 								/*
 								 * check if the ranges have been set to the function name
 								 * */
@@ -1216,6 +2615,8 @@ rangeAnalysis(State * N, llvm::Function & llvmIrFunction, BoundInfo * boundInfo,
 										innerBoundInfo->virtualRegisterRange.emplace(calledFunction->getArg(idx),
 															     std::make_pair(static_cast<double>(constIntValue),
 																	    static_cast<double>(constIntValue)));
+										calleeContext.second.emplace_back(static_cast<double>(constIntValue),
+														  static_cast<double>(constIntValue));
 										std::string argVal = std::to_string(constIntValue);
 										if (argRanges.empty())
 											newFuncName = newFuncName + "_" + argVal + "_" + argVal;
@@ -1229,6 +2630,7 @@ rangeAnalysis(State * N, llvm::Function & llvmIrFunction, BoundInfo * boundInfo,
 										flexprint(N->Fe, N->Fm, N->Fpinfo, "\tCall: It's a constant double value: %f.\n", constDoubleValue);
 										innerBoundInfo->virtualRegisterRange.emplace(calledFunction->getArg(idx),
 															     std::make_pair(constDoubleValue, constDoubleValue));
+										calleeContext.second.emplace_back(constDoubleValue, constDoubleValue);
 										std::string argVal = std::to_string((int)constDoubleValue);
 										if (argRanges.empty())
 											newFuncName = newFuncName + "_" + argVal + "_" + argVal;
@@ -1248,6 +2650,7 @@ rangeAnalysis(State * N, llvm::Function & llvmIrFunction, BoundInfo * boundInfo,
 											flexprint(N->Fe, N->Fm, N->Fpinfo, "\tCall: the range of the operand is: %f - %f.\n",
 												  vrRangeIt->second.first, vrRangeIt->second.second);
 											innerBoundInfo->virtualRegisterRange.emplace(calledFunction->getArg(idx), vrRangeIt->second);
+											calleeContext.second.emplace_back(vrRangeIt->second);
 											std::string argLowVal  = std::to_string((int)vrRangeIt->second.first);
 											std::string argHighVal = std::to_string((int)vrRangeIt->second.second);
 											if (argRanges.empty())
@@ -1258,12 +2661,105 @@ rangeAnalysis(State * N, llvm::Function & llvmIrFunction, BoundInfo * boundInfo,
 										else
 										{
 											assert(!valueRangeDebug && "failed to get range");
+											calleeContext.second.emplace_back(std::numeric_limits<double>::infinity(),
+															  -std::numeric_limits<double>::infinity());
 										}
 									}
 								}
+								/*
+								 * -0.0 and 0.0 are the same bound
+								 * */
+								for (auto & argRange : calleeContext.second)
+								{
+									argRange.first += 0.0;
+									argRange.second += 0.0;
+								}
 								Function *					    realCallee;
 								std::pair<llvm::Value *, std::pair<double, double>> returnRange;
-								if (useOverLoad && hasSpecificRange)
+								/*
+								 * a context already specialized calls the same clone,
+								 * a new context is cloned if the clone fits in the size budget.
+								 * Out of the budget, the callee and its callees are analyzed without overloading,
+								 * as overloading changes the calls in the body of the callee.
+								 * */
+								Specialization *		      specialization	= boundInfo->specialization;
+								std::pair<Function *, CalleeSummary> * specializedCallee = nullptr;
+								bool				      isSpecialized	= useOverLoad && hasSpecificRange;
+								bool				      calleeOverLoad	= useOverLoad;
+								/*
+								 * on a revisit of the call, the call already calls its clone:
+								 * the context and the clones are the ones of the callee it is cloned from
+								 * */
+								Function * originalCallee = calledFunction;
+								if (specialization != nullptr)
+								{
+									auto soIt = specialization->origins.find(calledFunction);
+									if (soIt != specialization->origins.end())
+										originalCallee = soIt->second;
+								}
+								CalleeContext specializationContext(originalCallee, calleeContext.second);
+								if (isSpecialized && specialization != nullptr)
+								{
+									auto scIt = specialization->clones.find(specializationContext);
+									if (scIt != specialization->clones.end())
+									{
+										specializedCallee = &scIt->second;
+									}
+									else if (specialization->budget < originalCallee->getInstructionCount())
+									{
+										flexprint(N->Fe, N->Fm, N->Fpinfo, "\tCall: %s is not specialized, out of the size budget.\n",
+											  originalCallee->getName().str().c_str());
+										isSpecialized  = false;
+										calleeOverLoad = false;
+									}
+									else
+									{
+										specialization->budget -= originalCallee->getInstructionCount();
+									}
+								}
+								/*
+								 * a clone is analyzed with the ranges of its own arguments
+								 * */
+								if (isSpecialized)
+								{
+									delete innerBoundInfo;
+									innerBoundInfo = nullptr;
+								}
+								if (specializedCallee != nullptr)
+								{
+									realCallee			 = specializedCallee->first;
+									BoundInfo * overloadBoundInfo = specializedCallee->second.boundInfo;
+									returnRange			 = specializedCallee->second.returnRange;
+									flexprint(N->Fe, N->Fm, N->Fpinfo, "\tCall: reuse the specialization %s.\n",
+										  realCallee->getName().str().c_str());
+									llvmIrCallInstruction->setCalledFunction(realCallee);
+									/*
+									 * the pointer arguments are updated as after the analysis of a new clone
+									 * */
+									for (size_t idx = 0; idx < llvmIrCallInstruction->getNumOperands() - 1; idx++)
+									{
+										auto operand = llvmIrCallInstruction->getOperand(idx);
+										if (!operand->getType()->isPointerTy())
+											continue;
+										auto vrIt = boundInfo->virtualRegisterRange.find(operand);
+										if (vrIt == boundInfo->virtualRegisterRange.end())
+											continue;
+										auto obIt = overloadBoundInfo->virtualRegisterRange.find(operand);
+										if (obIt != overloadBoundInfo->virtualRegisterRange.end())
+											vrIt->second = obIt->second;
+										else
+											boundInfo->virtualRegisterRange.erase(vrIt);
+									}
+									if (returnRange.first != nullptr)
+									{
+										boundInfo->virtualRegisterRange.emplace(llvmIrCallInstruction, returnRange.second);
+									}
+									for (Value * arrayBase : callArrayRange(boundInfo, llvmIrCallInstruction, overloadBoundInfo))
+									{
+										enqueueArrayLoads(arrayBase);
+									}
+								}
+								else if (isSpecialized)
 								{
 									auto	 newFuncPos = calledFunction->getIterator();
 									Module & funcModule = *calledFunction->getParent();
@@ -1274,8 +2770,16 @@ rangeAnalysis(State * N, llvm::Function & llvmIrFunction, BoundInfo * boundInfo,
 									if (callerMap.find(newFuncName) != callerMap.end())
 									{
 										newFuncPos = funcModule.getFunction(newFuncName)->getIterator();
-										newFuncName += "_dummy_";
-										newFuncName += std::to_string(std::rand());
+										/*
+										 * the first free name of the same clone name and a number
+										 * */
+										std::string cloneName = newFuncName;
+										for (size_t cloneNum = 1; callerMap.find(newFuncName) != callerMap.end() ||
+													  funcModule.getFunction(newFuncName) != nullptr;
+										     cloneNum++)
+										{
+											newFuncName = cloneName + "_" + std::to_string(cloneNum);
+										}
 									}
 									callerMap.emplace(newFuncName, llvmIrCallInstruction);
 									/*
@@ -1284,19 +2788,19 @@ rangeAnalysis(State * N, llvm::Function & llvmIrFunction, BoundInfo * boundInfo,
 									 * create a new function and insert it to the CallerMap
 									 * */
 									ValueToValueMapTy vMap;
-									realCallee	    = Function::Create(calledFunction->getFunctionType(),
-													       calledFunction->getLinkage(),
-													       calledFunction->getAddressSpace(),
+									realCallee	    = Function::Create(originalCallee->getFunctionType(),
+													       originalCallee->getLinkage(),
+													       originalCallee->getAddressSpace(),
 													       newFuncName);
 									auto * newFuncArgIt = realCallee->arg_begin();
-									for (auto & arg : calledFunction->args())
+									for (auto & arg : originalCallee->args())
 									{
 										auto argName = arg.getName();
 										newFuncArgIt->setName(argName);
 										vMap[&arg] = &(*newFuncArgIt++);
 									}
 									SmallVector<ReturnInst *, 8> Returns;
-									CloneFunctionInto(realCallee, calledFunction, vMap,
+									CloneFunctionInto(realCallee, originalCallee, vMap,
 											  CloneFunctionChangeType::LocalChangesOnly, Returns);
 									// Set the linkage and visibility late as CloneFunctionInto has some
 									// implicit requirements.
@@ -1305,7 +2809,7 @@ rangeAnalysis(State * N, llvm::Function & llvmIrFunction, BoundInfo * boundInfo,
 
 									// Copy metadata
 									SmallVector<std::pair<unsigned, MDNode *>, 1> MDs;
-									calledFunction->getAllMetadata(MDs);
+									originalCallee->getAllMetadata(MDs);
 									for (auto MDIt : MDs)
 									{
 										if (!realCallee->hasMetadata())
@@ -1325,6 +2829,8 @@ rangeAnalysis(State * N, llvm::Function & llvmIrFunction, BoundInfo * boundInfo,
 									 * // todo: this code is a bit wired, maybe can be improved
 									 * */
 									auto overloadBoundInfo = new BoundInfo();
+									overloadBoundInfo->virtualRegisterRange.shareGlobalRanges(boundInfo->virtualRegisterRange.getGlobalRanges());
+									overloadBoundInfo->specialization = specialization;
 									for (size_t idx = 0; idx < llvmIrCallInstruction->getNumOperands() - 1; idx++)
 									{
 										/*
@@ -1380,9 +2886,9 @@ rangeAnalysis(State * N, llvm::Function & llvmIrFunction, BoundInfo * boundInfo,
                                         if (operand->getType()->getTypeID() == Type::PointerTyID) {
                                             auto vrIt = boundInfo->virtualRegisterRange.find(operand);
                                             if (vrIt != boundInfo->virtualRegisterRange.end()) {
-                                                auto ibIt = innerBoundInfo->virtualRegisterRange.find(operand);
-                                                if (ibIt != innerBoundInfo->virtualRegisterRange.end()) {
-                                                    vrIt->second = ibIt->second;
+                                                auto obIt = overloadBoundInfo->virtualRegisterRange.find(operand);
+                                                if (obIt != overloadBoundInfo->virtualRegisterRange.end()) {
+                                                    vrIt->second = obIt->second;
                                                 } else {
                                                     boundInfo->virtualRegisterRange.erase(vrIt);
                                                 }
@@ -1393,7 +2899,17 @@ rangeAnalysis(State * N, llvm::Function & llvmIrFunction, BoundInfo * boundInfo,
 									{
 										boundInfo->virtualRegisterRange.emplace(llvmIrCallInstruction, returnRange.second);
 									}
+									for (Value * arrayBase : callArrayRange(boundInfo, llvmIrCallInstruction, overloadBoundInfo))
+									{
+										enqueueArrayLoads(arrayBase);
+									}
 									boundInfo->calleeBound.emplace(newFuncName, overloadBoundInfo);
+									if (specialization != nullptr)
+									{
+										specialization->clones.emplace(specializationContext,
+													       std::make_pair(realCallee, CalleeSummary{overloadBoundInfo, returnRange}));
+										specialization->origins.emplace(realCallee, originalCallee);
+									}
 								}
 								else
 								{
@@ -1401,9 +2917,36 @@ rangeAnalysis(State * N, llvm::Function & llvmIrFunction, BoundInfo * boundInfo,
 									 * if we don't use overload function here, for variables of innerBoundInfo
 									 * that has been stored in boundInfo, we get the union set of them
 									 * */
-									realCallee  = calledFunction;
-									returnRange = rangeAnalysis(N, *realCallee, innerBoundInfo, callerMap,
-												    typeRange, virtualRegisterVectorRange, useOverLoad);
+									realCallee = calledFunction;
+									/*
+									 * the ranges of the callee only depend on the ranges of its arguments and the global variables,
+									 * so the calls in the same context share one summary.
+									 * */
+									CalleeSummary * calleeSummary = nullptr;
+									if (boundInfo->calleeSummary != nullptr)
+									{
+										auto csIt = boundInfo->calleeSummary->find(calleeContext);
+										if (csIt != boundInfo->calleeSummary->end())
+											calleeSummary = &csIt->second;
+									}
+									if (calleeSummary != nullptr)
+									{
+										flexprint(N->Fe, N->Fm, N->Fpinfo, "\tCall: reuse the summary of %s.\n",
+											  realCallee->getName().str().c_str());
+										delete innerBoundInfo;
+										innerBoundInfo = calleeSummary->boundInfo;
+										returnRange    = calleeSummary->returnRange;
+									}
+									else
+									{
+										returnRange = rangeAnalysis(N, *realCallee, innerBoundInfo, callerMap,
+													    typeRange, virtualRegisterVectorRange, calleeOverLoad);
+										if (boundInfo->calleeSummary != nullptr)
+										{
+											boundInfo->calleeSummary->emplace(calleeContext,
+															  CalleeSummary{innerBoundInfo, returnRange});
+										}
+									}
                                     /*
                                      * If the "realCallee" pass arguments by pointer, update the pointer argus.
                                      * If the outer function have such operand value, but doesn't exist after the callee,
@@ -1428,6 +2971,10 @@ rangeAnalysis(State * N, llvm::Function & llvmIrFunction, BoundInfo * boundInfo,
 									{
 										boundInfo->virtualRegisterRange.emplace(llvmIrCallInstruction, returnRange.second);
 									}
+									for (Value * arrayBase : callArrayRange(boundInfo, llvmIrCallInstruction, innerBoundInfo))
+									{
+										enqueueArrayLoads(arrayBase);
+									}
 									for (const auto & vrRange : innerBoundInfo->virtualRegisterRange)
 									{
 										auto ibIt = boundInfo->virtualRegisterRange.find(vrRange.first);
@@ -1443,6 +2990,14 @@ rangeAnalysis(State * N, llvm::Function & llvmIrFunction, BoundInfo * boundInfo,
 											boundInfo->virtualRegisterRange.emplace(vrRange.first, vrRange.second);
 										}
 									}
+									/*
+									 * a summary keeps the BoundInfo of the callee, otherwise only the clones specialized in the callee outlive it
+									 * */
+									if (boundInfo->calleeSummary == nullptr)
+									{
+										boundInfo->calleeBound.insert(innerBoundInfo->calleeBound.begin(), innerBoundInfo->calleeBound.end());
+										delete innerBoundInfo;
+									}
 								}
 								/*
 								 * Check the return type of the function,
@@ -2577,12 +4132,10 @@ rangeAnalysis(State * N, llvm::Function & llvmIrFunction, BoundInfo * boundInfo,
 							vrRangeIt = boundInfo->virtualRegisterRange.find(rightOperand);
 							if (vrRangeIt != boundInfo->virtualRegisterRange.end())
 							{
-								std::pair<int64_t, int64_t> and_res = bitwiseInterval(lowerBound, upperBound,
-														      vrRangeIt->second.first,
-														      vrRangeIt->second.second,
-														      "and");
 								boundInfo->virtualRegisterRange.emplace(llvmIrBinaryOperator,
-													std::make_pair(and_res.first, and_res.second));
+													bitwiseRange(llvmIrBinaryOperator,
+														     leftOperand, std::make_pair(lowerBound, upperBound),
+														     rightOperand, vrRangeIt->second));
 							}
 							else
 							{
@@ -2610,12 +4163,10 @@ rangeAnalysis(State * N, llvm::Function & llvmIrFunction, BoundInfo * boundInfo,
 							auto vrRangeIt = boundInfo->virtualRegisterRange.find(leftOperand);
 							if (vrRangeIt != boundInfo->virtualRegisterRange.end())
 							{
-								std::pair<int64_t, int64_t> and_res = bitwiseInterval(constValue, constValue,
-														      vrRangeIt->second.first,
-														      vrRangeIt->second.second,
-														      "and");
 								boundInfo->virtualRegisterRange.emplace(llvmIrBinaryOperator,
-													std::make_pair(and_res.first, and_res.second));
+													bitwiseRange(llvmIrBinaryOperator,
+														     rightOperand, std::make_pair(constValue, constValue),
+														     leftOperand, vrRangeIt->second));
 							}
 							else
 							{
@@ -2667,12 +4218,10 @@ rangeAnalysis(State * N, llvm::Function & llvmIrFunction, BoundInfo * boundInfo,
 							vrRangeIt = boundInfo->virtualRegisterRange.find(rightOperand);
 							if (vrRangeIt != boundInfo->virtualRegisterRange.end())
 							{
-								std::pair<int64_t, int64_t> and_res = bitwiseInterval(lowerBound, upperBound,
-														      vrRangeIt->second.first,
-														      vrRangeIt->second.second,
-														      "or");
 								boundInfo->virtualRegisterRange.emplace(llvmIrBinaryOperator,
-													std::make_pair(and_res.first, and_res.second));
+													bitwiseRange(llvmIrBinaryOperator,
+														     leftOperand, std::make_pair(lowerBound, upperBound),
+														     rightOperand, vrRangeIt->second));
 							}
 							else
 							{
@@ -2700,12 +4249,10 @@ rangeAnalysis(State * N, llvm::Function & llvmIrFunction, BoundInfo * boundInfo,
 							auto vrRangeIt = boundInfo->virtualRegisterRange.find(leftOperand);
 							if (vrRangeIt != boundInfo->virtualRegisterRange.end())
 							{
-								std::pair<int64_t, int64_t> and_res = bitwiseInterval(constValue, constValue,
-														      vrRangeIt->second.first,
-														      vrRangeIt->second.second,
-														      "or");
 								boundInfo->virtualRegisterRange.emplace(llvmIrBinaryOperator,
-													std::make_pair(and_res.first, and_res.second));
+													bitwiseRange(llvmIrBinaryOperator,
+														     rightOperand, std::make_pair(constValue, constValue),
+														     leftOperand, vrRangeIt->second));
 							}
 							else
 							{
@@ -2757,12 +4304,10 @@ rangeAnalysis(State * N, llvm::Function & llvmIrFunction, BoundInfo * boundInfo,
 							vrRangeIt = boundInfo->virtualRegisterRange.find(rightOperand);
 							if (vrRangeIt != boundInfo->virtualRegisterRange.end())
 							{
-								std::pair<int64_t, int64_t> and_res = bitwiseInterval(lowerBound, upperBound,
-														      vrRangeIt->second.first,
-														      vrRangeIt->second.second,
-														      "xor");
 								boundInfo->virtualRegisterRange.emplace(llvmIrBinaryOperator,
-													std::make_pair(and_res.first, and_res.second));
+													bitwiseRange(llvmIrBinaryOperator,
+														     leftOperand, std::make_pair(lowerBound, upperBound),
+														     rightOperand, vrRangeIt->second));
 							}
 							else
 							{
@@ -2790,12 +4335,10 @@ rangeAnalysis(State * N, llvm::Function & llvmIrFunction, BoundInfo * boundInfo,
 							auto vrRangeIt = boundInfo->virtualRegisterRange.find(leftOperand);
 							if (vrRangeIt != boundInfo->virtualRegisterRange.end())
 							{
-								std::pair<int64_t, int64_t> and_res = bitwiseInterval(constValue, constValue,
-														      vrRangeIt->second.first,
-														      vrRangeIt->second.second,
-														      "xor");
 								boundInfo->virtualRegisterRange.emplace(llvmIrBinaryOperator,
-													std::make_pair(and_res.first, and_res.second));
+													bitwiseRange(llvmIrBinaryOperator,
+														     rightOperand, std::make_pair(constValue, constValue),
+														     leftOperand, vrRangeIt->second));
 							}
 							else
 							{
@@ -2838,10 +4381,10 @@ rangeAnalysis(State * N, llvm::Function & llvmIrFunction, BoundInfo * boundInfo,
 				case Instruction::Load:
 					if (auto llvmIrLoadInstruction = dyn_cast<LoadInst>(&llvmIrInstruction))
 					{
-						auto vrRangeIt = boundInfo->virtualRegisterRange.find(llvmIrLoadInstruction->getOperand(0));
-						if (vrRangeIt != boundInfo->virtualRegisterRange.end())
+						std::pair<double, double> loadRange;
+						if (getLoadRange(memorySSA, aliasAnalysis, loopStoreRanges, boundInfo, llvmIrLoadInstruction, loadRange))
 						{
-							boundInfo->virtualRegisterRange.emplace(llvmIrLoadInstruction, vrRangeIt->second);
+							boundInfo->virtualRegisterRange.emplace(llvmIrLoadInstruction, loadRange);
 						}
 						else
 						{
@@ -2922,6 +4465,13 @@ rangeAnalysis(State * N, llvm::Function & llvmIrFunction, BoundInfo * boundInfo,
 									boundInfo->virtualRegisterRange.emplace(uaIt->second, vrRangeIt->second);
 							}
 						}
+						/*
+						 * the store to an array is also kept in its summary
+						 * */
+						if (Value * arrayBase = storeArrayRange(boundInfo, llvmIrStoreInstruction, visitedBlocks))
+						{
+							enqueueArrayLoads(arrayBase);
+						}
 					}
 					break;
 
@@ -2949,6 +4499,12 @@ rangeAnalysis(State * N, llvm::Function & llvmIrFunction, BoundInfo * boundInfo,
 						 *    and reinterpret it if necessary
 						 * */
 						unionAddress.emplace(llvmIrBitCastInstruction, llvmIrBitCastInstruction->getOperand(0));
+						std::pair<double, double> fieldRange;
+						if (getFieldRange(boundInfo, llvmIrBitCastInstruction, llvmIrFunction.getParent()->getDataLayout(), fieldRange))
+						{
+							boundInfo->virtualRegisterRange.emplace(llvmIrBitCastInstruction, fieldRange);
+							break;
+						}
 						assert(llvmIrBitCastInstruction->getDestTy()->getTypeID() == Type::PointerTyID);
 						auto vrRangeIt = boundInfo->virtualRegisterRange.find(llvmIrBitCastInstruction->getOperand(0));
 						if (vrRangeIt != boundInfo->virtualRegisterRange.end())
@@ -3030,7 +4586,7 @@ rangeAnalysis(State * N, llvm::Function & llvmIrFunction, BoundInfo * boundInfo,
 									default:
 										flexprint(N->Fe, N->Fm, N->Fpinfo, "\tBitCast: Do not support other type yet.\n");
 										boundInfo->virtualRegisterRange.emplace(llvmIrBitCastInstruction, vrRangeIt->second);
-										continue;
+										break;
 								}
 							}
 							else
@@ -3075,7 +4631,15 @@ rangeAnalysis(State * N, llvm::Function & llvmIrFunction, BoundInfo * boundInfo,
 						 * 2. get the value-holder bitcast instruction from the map
 						 * 3. check if the range of the value-holder has been inferred
 						 * 4. get the variable info from the value-holder, and cast it if necessary
+						 *
+						 * A field whose member has a sensor type gets the range of the type instead.
 						 * */
+						std::pair<double, double> fieldRange;
+						if (getFieldRange(boundInfo, llvmIrGetElePtrInstruction, llvmIrFunction.getParent()->getDataLayout(), fieldRange))
+						{
+							boundInfo->virtualRegisterRange.emplace(llvmIrGetElePtrInstruction, fieldRange);
+							break;
+						}
 						auto uaIt = unionAddress.find(llvmIrGetElePtrInstruction->getPointerOperand());
 						if (uaIt != unionAddress.end())
 						{
@@ -3164,7 +4728,7 @@ rangeAnalysis(State * N, llvm::Function & llvmIrFunction, BoundInfo * boundInfo,
 										default:
 											flexprint(N->Fe, N->Fm, N->Fpinfo, "\tGetElePtr: Do not support other type yet.\n");
 											boundInfo->virtualRegisterRange.emplace(llvmIrGetElePtrInstruction, vrRangeIt->second);
-											continue;
+											break;
 									}
 								}
 								else
@@ -3227,16 +4791,17 @@ rangeAnalysis(State * N, llvm::Function & llvmIrFunction, BoundInfo * boundInfo,
 							}
 						}
 					}
+					break;
 
 				case Instruction::Ret:
 					if (auto llvmIrReturnInstruction = dyn_cast<ReturnInst>(&llvmIrInstruction))
 					{
 						if (llvmIrReturnInstruction->getNumOperands() != 0)
 						{
-							auto vrRangeIt = boundInfo->virtualRegisterRange.find(llvmIrReturnInstruction->getOperand(0));
-							if (vrRangeIt != boundInfo->virtualRegisterRange.end())
+							std::pair<double, double> returnRange;
+							if (getValueRange(llvmIrReturnInstruction->getOperand(0), boundInfo, returnRange))
 							{
-								return {llvmIrReturnInstruction, vrRangeIt->second};
+								returnRanges[llvmIrReturnInstruction] = returnRange;
 							}
 							else
 							{
@@ -3264,23 +4829,199 @@ rangeAnalysis(State * N, llvm::Function & llvmIrFunction, BoundInfo * boundInfo,
 						}
 					}
 					break;
+				case Instruction::ICmp:
+				case Instruction::FCmp:
+					/*
+					 * [1, 1] if the comparison always holds, [0, 0] if it never does,
+					 * so that `simplifyControlFlow()` can fold it with the restricted ranges of this block
+					 * */
+					if (auto llvmIrCmpInstruction = dyn_cast<CmpInst>(&llvmIrInstruction))
+					{
+						std::pair<double, double> lhsRange, rhsRange;
+						Value *			  lhs = llvmIrCmpInstruction->getOperand(0);
+						Value *			  rhs = llvmIrCmpInstruction->getOperand(1);
+						if (!getCompareOperandRanges(llvmIrCmpInstruction, boundInfo, lhsRange, rhsRange))
+						{
+							/*
+							 * without the ranges of the operands, their difference may still decide it
+							 * */
+							if (!useRelationalDomain || isa<llvm::Constant>(lhs) || isa<llvm::Constant>(rhs) ||
+							    (!lhs->getType()->isIntegerTy() && !lhs->getType()->isFloatingPointTy()))
+								break;
+							lhsRange = getTypeBound(lhs->getType());
+							rhsRange = getTypeBound(rhs->getType());
+						}
+						bool isInteger	   = lhs->getType()->isIntegerTy();
+						bool neverNaN	   = isKnownNeverNaN(lhs, nullptr) && isKnownNeverNaN(rhs, nullptr);
+						auto trueLhsRange  = lhsRange, trueRhsRange = rhsRange;
+						bool canBeTrue	   = refineRangeByPredicate(llvmIrCmpInstruction->getPredicate(), isInteger, neverNaN,
+											    trueLhsRange, trueRhsRange);
+						bool canBeFalse	   = refineRangeByPredicate(llvmIrCmpInstruction->getInversePredicate(), isInteger, neverNaN,
+											    lhsRange, rhsRange);
+						/*
+						 * the intervals can't decide it, but the difference between the operands may,
+						 * e.g. `%y = sub nsw i32 %x, 1` always makes `icmp slt i32 %y, %x` hold
+						 * */
+						std::pair<double, double> differenceRange;
+						auto			  predicate = llvmIrCmpInstruction->getPredicate();
+						if (canBeTrue && canBeFalse && useRelationalDomain &&
+						    (!CmpInst::isUnsigned(predicate) || (lhsRange.first >= 0 && rhsRange.first >= 0)) &&
+						    getDifferenceRange(llvmIrCmpInstruction, boundInfo, dominatorTree, differenceRange))
+						{
+							if (CmpInst::isUnsigned(predicate))
+								predicate = ICmpInst::getSignedPredicate(predicate);
+							auto zeroRange	    = std::make_pair(0.0, 0.0);
+							auto trueDifference = differenceRange;
+							canBeTrue	    = refineRangeByPredicate(predicate, isInteger, neverNaN, trueDifference, zeroRange);
+							zeroRange	    = std::make_pair(0.0, 0.0);
+							canBeFalse	    = refineRangeByPredicate(CmpInst::getInversePredicate(predicate), isInteger, neverNaN,
+												     differenceRange, zeroRange);
+							if (!canBeTrue || !canBeFalse)
+								flexprint(N->Fe, N->Fm, N->Fpinfo, "\tCmp: decided by the difference bounds\n");
+						}
+						if (canBeTrue || canBeFalse)
+						{
+							boundInfo->virtualRegisterRange.emplace(llvmIrCmpInstruction,
+												std::make_pair(canBeFalse ? 0 : 1, canBeTrue ? 1 : 0));
+						}
+					}
+					break;
+
 				case Instruction::Br:
 					if (auto llvmIrBrInstruction = dyn_cast<BranchInst>(&llvmIrInstruction))
 					{
+						if (!llvmIrBrInstruction->isConditional() ||
+						    llvmIrBrInstruction->getSuccessor(0) == llvmIrBrInstruction->getSuccessor(1))
+							break;
+						for (unsigned idx = 0; idx < 2; idx++)
+						{
+							std::map<Value *, std::pair<double, double>> conditionRanges;
+							if (!getConditionRanges(llvmIrBrInstruction->getCondition(), idx == 0, boundInfo, conditionRanges))
+							{
+								/*
+								 * the edge is never taken, which is left to `simplifyControlFlow()`
+								 * */
+								conditionRanges.clear();
+							}
+							updateEdgeRanges(&llvmIrBasicBlock, llvmIrBrInstruction->getSuccessor(idx), conditionRanges);
+						}
 					}
 					break;
 
 				case Instruction::PHI:
 					if (auto llvmIRPhiNode = dyn_cast<PHINode>(&llvmIrInstruction))
 					{
-						checkPhiRange(N, llvmIRPhiNode, boundInfo, virtualRegisterVectorRange);
+						/*
+						 * an incoming value is restricted by the block it comes from and by the edge into this block
+						 * */
+						std::map<BasicBlock *, std::map<Value *, std::pair<double, double>>> incomingRanges;
+						for (size_t idx = 0; idx < llvmIRPhiNode->getNumIncomingValues(); idx++)
+						{
+							Value *	     incomingValue = llvmIRPhiNode->getIncomingValue(idx);
+							BasicBlock * incomingBlock = llvmIRPhiNode->getIncomingBlock(idx);
+							if (isa<llvm::Constant>(incomingValue))
+								continue;
+							std::vector<std::pair<double, double>> restrictions;
+							auto blockRanges = getBlockRanges(incomingBlock);
+							if (blockRanges.find(incomingValue) != blockRanges.end())
+								restrictions.emplace_back(blockRanges[incomingValue]);
+							auto erIt = edgeRanges.find(std::make_pair(incomingBlock, &llvmIrBasicBlock));
+							if (erIt != edgeRanges.end() && erIt->second.find(incomingValue) != erIt->second.end())
+								restrictions.emplace_back(erIt->second[incomingValue]);
+							if (restrictions.empty())
+								continue;
+							auto incomingRange = restrictions.front();
+							if (restrictions.size() > 1)
+								incomingRange = narrowRange(incomingRange, restrictions.back());
+							incomingRanges[incomingBlock][incomingValue] = incomingRange;
+						}
+						checkPhiRange(N, llvmIRPhiNode, boundInfo, virtualRegisterVectorRange, visitedBlocks, incomingRanges);
 					}
 					break;
 
 				case Instruction::Select:
+					/*
+					 * the union of the arms that can be selected, each restricted by the condition selecting it,
+					 * e.g. for the clamp `%y = select i1 %c, double 0.0, double %x` with `%c = fcmp olt double %x, 0.0`,
+					 * %x is only selected where it is not negative
+					 * */
+					if (auto llvmIrSelectInstruction = dyn_cast<SelectInst>(&llvmIrInstruction))
+					{
+						std::vector<std::pair<double, double>> armRanges;
+						for (unsigned idx = 0; idx < 2; idx++)
+						{
+							Value *					     armValue = idx == 0 ? llvmIrSelectInstruction->getTrueValue()
+														 : llvmIrSelectInstruction->getFalseValue();
+							std::map<Value *, std::pair<double, double>> conditionRanges;
+							if (!getConditionRanges(llvmIrSelectInstruction->getCondition(), idx == 0, boundInfo, conditionRanges))
+								continue;
+							std::pair<double, double> armRange;
+							auto			  crIt = conditionRanges.find(armValue);
+							if (crIt != conditionRanges.end())
+							{
+								armRange = crIt->second;
+							}
+							else if (!getValueRange(armValue, boundInfo, armRange))
+							{
+								armRanges.clear();
+								break;
+							}
+							armRanges.emplace_back(armRange);
+						}
+						if (armRanges.empty())
+							break;
+						auto selectRange = armRanges.front();
+						for (const auto & armRange : armRanges)
+						{
+							selectRange = std::make_pair(min(selectRange.first, armRange.first),
+										     max(selectRange.second, armRange.second));
+						}
+						boundInfo->virtualRegisterRange.emplace(llvmIrSelectInstruction, selectRange);
+					}
 					break;
 
 				case Instruction::Switch:
+					/*
+					 * the destination of a case is only entered with the value of the case
+					 * */
+					if (auto llvmIrSwitchInstruction = dyn_cast<SwitchInst>(&llvmIrInstruction))
+					{
+						Value * condition = llvmIrSwitchInstruction->getCondition();
+						if (isa<llvm::Constant>(condition))
+							break;
+						std::pair<double, double>		     conditionRange;
+						bool					     hasRange = getValueRange(condition, boundInfo, conditionRange);
+						std::map<BasicBlock *, std::pair<double, double>> caseRanges;
+						for (auto & switchCase : llvmIrSwitchInstruction->cases())
+						{
+							double caseValue = static_cast<double>(switchCase.getCaseValue()->getSExtValue());
+							if (hasRange && (caseValue < conditionRange.first || caseValue > conditionRange.second))
+								continue;
+							auto crIt = caseRanges.find(switchCase.getCaseSuccessor());
+							if (crIt == caseRanges.end())
+							{
+								caseRanges.emplace(switchCase.getCaseSuccessor(), std::make_pair(caseValue, caseValue));
+							}
+							else
+							{
+								crIt->second = std::make_pair(min(crIt->second.first, caseValue), max(crIt->second.second, caseValue));
+							}
+						}
+						std::set<BasicBlock *> successors;
+						for (unsigned idx = 0; idx < llvmIrSwitchInstruction->getNumSuccessors(); idx++)
+						{
+							BasicBlock * successor = llvmIrSwitchInstruction->getSuccessor(idx);
+							if (!successors.emplace(successor).second)
+								continue;
+							std::map<Value *, std::pair<double, double>> conditionRanges;
+							auto					     crIt = caseRanges.find(successor);
+							if (successor != llvmIrSwitchInstruction->getDefaultDest() && crIt != caseRanges.end())
+							{
+								conditionRanges.emplace(condition, crIt->second);
+							}
+							updateEdgeRanges(&llvmIrBasicBlock, successor, conditionRanges);
+						}
+					}
 					break;
 
 				case Instruction::IndirectBr:
@@ -3310,10 +5051,146 @@ rangeAnalysis(State * N, llvm::Function & llvmIrFunction, BoundInfo * boundInfo,
 				case Instruction::LandingPad:
 				case Instruction::Freeze:
 				default:
+					break;
+			}
+
+			/*
+			 * the calls we don't analyze may store to the arrays they get
+			 * */
+			if (auto llvmIrCallInstruction = dyn_cast<CallInst>(&llvmIrInstruction))
+			{
+				Function * calledFunction = llvmIrCallInstruction->getCalledFunction();
+				if (calledFunction == nullptr || calledFunction->isDeclaration())
+				{
+					for (Value * arrayBase : callArrayRange(boundInfo, llvmIrCallInstruction, nullptr))
+					{
+						enqueueArrayLoads(arrayBase);
+					}
+				}
+			}
+
+			for (size_t idx = 0; idx < writtenValues.size(); idx++)
+			{
+				Value * writtenValue = writtenValues[idx];
+				auto &	oldRange     = oldRanges[idx];
+				auto	vrRangeIt    = boundInfo->virtualRegisterRange.find(writtenValue);
+				if (vrRangeIt == boundInfo->virtualRegisterRange.end())
+				{
+					if (oldRange.first && writtenValue == &llvmIrInstruction)
+					{
+						/*
+						 * an operand lost its range in this visit, so the range inferred before no longer holds:
+						 * the value may be anything its type holds
+						 * */
+						Type * valueType = writtenValue->getType()->isPointerTy() ? writtenValue->getType()->getPointerElementType()
+													 : writtenValue->getType();
+						if (valueType->isIntegerTy() || valueType->isFloatingPointTy())
+						{
+							auto typeBound = getTypeBound(writtenValue->getType());
+							boundInfo->virtualRegisterRange.emplace(writtenValue, typeBound);
+							if (typeBound != oldRange.second)
+								enqueueUsers(writtenValue, &llvmIrInstruction);
+						}
+						else
+						{
+							enqueueUsers(writtenValue, &llvmIrInstruction);
+						}
+					}
+					else if (oldRange.first)
+					{
+						enqueueUsers(writtenValue, &llvmIrInstruction);
+					}
 					continue;
+				}
+				auto newRange	 = vrRangeIt->second;
+				bool isLoopStore = isInLoop && isa<StoreInst>(llvmIrInstruction);
+				bool changed	 = !oldRange.first || newRange != oldRange.second;
+				/*
+				 * a store inside a loop keeps the values it stored in the other iterations.
+				 * This is kept for the store instead of its address,
+				 * which the stores outside the loop overwrite on each visit.
+				 * */
+				auto lsIt = isLoopStore ? loopStoreRanges.find(&llvmIrInstruction) : loopStoreRanges.end();
+				if (lsIt != loopStoreRanges.end())
+				{
+					auto lastRange = lsIt->second;
+					if (narrowing)
+					{
+						newRange = narrowRange(lastRange, newRange);
+					}
+					else
+					{
+						newRange = std::make_pair(min(lastRange.first, newRange.first), max(lastRange.second, newRange.second));
+						if (visits > WideningDelay && newRange != lastRange)
+						{
+							newRange = widenRange(lastRange, newRange,
+									      cast<StoreInst>(llvmIrInstruction).getValueOperand()->getType());
+							widened	 = true;
+						}
+					}
+					lsIt->second = newRange;
+					changed	     = changed || newRange != lastRange;
+					/*
+					 * the address also keeps what was stored before the loop
+					 * */
+					if (oldRange.first)
+					{
+						newRange = std::make_pair(min(oldRange.second.first, newRange.first),
+									  max(oldRange.second.second, newRange.second));
+					}
+				}
+				else if (isLoopStore)
+				{
+					loopStoreRanges.emplace(&llvmIrInstruction, newRange);
+					changed = true;
+				}
+				else if (isLoopHeader && writtenValue == &llvmIrInstruction && oldRange.first)
+				{
+					if (narrowing)
+					{
+						newRange = narrowRange(oldRange.second, newRange);
+					}
+					else if (visits > WideningDelay &&
+						 (newRange.first < oldRange.second.first || newRange.second > oldRange.second.second))
+					{
+						newRange = widenRange(oldRange.second, newRange, writtenValue->getType());
+						widened	 = true;
+					}
+				}
+				vrRangeIt->second = newRange;
+				if (changed || newRange != oldRange.second)
+				{
+					enqueueUsers(writtenValue, &llvmIrInstruction);
+				}
+			}
+		}
+		for (const auto & unrestrictedRange : unrestrictedRanges)
+		{
+			if (unrestrictedRange.second.first)
+			{
+				boundInfo->virtualRegisterRange[unrestrictedRange.first] = unrestrictedRange.second.second;
+			}
+			else
+			{
+				boundInfo->virtualRegisterRange.erase(unrestrictedRange.first);
 			}
 		}
+		visitedBlocks.emplace(&llvmIrBasicBlock);
+	}
+
+	/*
+	 * the range of the return value is the union of all the returned ranges
+	 * */
+	if (returnRanges.empty())
+	{
+		return {nullptr, {}};
+	}
+	std::pair<Value *, std::pair<double, double>> returnRange = {returnRanges.begin()->first, returnRanges.begin()->second};
+	for (const auto & retRange : returnRanges)
+	{
+		returnRange.second.first  = min(returnRange.second.first, retRange.second.first);
+		returnRange.second.second = max(returnRange.second.second, retRange.second.second);
 	}
-	return {nullptr, {}};
+	return returnRange;
 }
 }
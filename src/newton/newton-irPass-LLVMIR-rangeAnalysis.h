@@ -39,9 +39,9 @@
 
 #include <algorithm>
 #include <assert.h>
-#include <bitset>
 #include <numeric>
 #include <cmath>
+#include <deque>
 #include <float.h>
 #include <limits>
 #include <regex>
@@ -57,27 +57,278 @@
 #include <unordered_map>
 #include <vector>
 
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/PostOrderIterator.h"
+#include "llvm/Analysis/AliasAnalysis.h"
+#include "llvm/Analysis/AssumptionCache.h"
+#include "llvm/Analysis/BasicAliasAnalysis.h"
+#include "llvm/Analysis/LoopInfo.h"
 #include "llvm/Analysis/MemorySSAUpdater.h"
+#include "llvm/Analysis/TargetLibraryInfo.h"
+#include "llvm/Analysis/TargetTransformInfo.h"
+#include "llvm/Analysis/ValueTracking.h"
 #include "llvm/Bitcode/BitcodeWriter.h"
 #include "llvm/IR/Constant.h"
+#include "llvm/IR/ConstantRange.h"
 #include "llvm/IR/DebugInfoMetadata.h"
+#include "llvm/IR/Dominators.h"
+#include "llvm/IR/GetElementPtrTypeIterator.h"
 #include "llvm/IR/LegacyPassManager.h"
 #include "llvm/IR/Metadata.h"
 #include "llvm/IR/Module.h"
 #include "llvm/IR/IRBuilder.h"
 #include "llvm/IR/Instructions.h"
 #include "llvm/IR/InstIterator.h"
+#include "llvm/IR/IntrinsicInst.h"
 #include "llvm/IR/Value.h"
+#include "llvm/IR/Verifier.h"
 #include "llvm/IRReader/IRReader.h"
+#include "llvm/MC/TargetRegistry.h"
+#include "llvm/Support/KnownBits.h"
 #include "llvm/Support/SourceMgr.h"
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/Support/Path.h"
+#include "llvm/Support/TargetSelect.h"
+#include "llvm/Target/TargetMachine.h"
 #include "llvm/Transforms/IPO.h"
 #include "llvm/Transforms/Scalar.h"
 #include "llvm/Transforms/Utils/BasicBlockUtils.h"
 #include "llvm/Transforms/Utils/Cloning.h"
 #include "llvm/Transforms/Utils/FunctionComparator.h"
 
+/*
+ * The ranges of the values, as a flat table instead of a tree node per value:
+ * the ranges are stored in the order they are inserted and indexed by a DenseMap.
+ * Erasing a range leaves a hole that is reused if the value is inserted again,
+ * so iterators and references stay valid while inserting.
+ *
+ * The ranges of the global variables are the same for every function, so a function shares
+ * the table of the global variables (`shareGlobalRanges()`) instead of copying it.
+ * A global range is only copied into this table when it is looked up to be changed (copy-on-write),
+ * so iterating over the table only visits the global ranges that have been looked up.
+ * */
+class ValueRangeMap {
+	public:
+	using key_type	  = llvm::Value *;
+	using mapped_type = std::pair<double, double>;
+	using value_type  = std::pair<llvm::Value * const, std::pair<double, double>>;
+
+	template <typename TableType, typename EntryType>
+	class Iterator {
+		public:
+		Iterator(TableType * table, size_t position)
+		    : table(table), position(position)
+		{
+			skipHoles();
+		}
+
+		EntryType &
+		operator*() const
+		{
+			return table->slots[position].range;
+		}
+
+		EntryType *
+		operator->() const
+		{
+			return &table->slots[position].range;
+		}
+
+		Iterator &
+		operator++()
+		{
+			position++;
+			skipHoles();
+			return *this;
+		}
+
+		bool
+		operator==(const Iterator & other) const
+		{
+			return table == other.table && position == other.position;
+		}
+
+		bool
+		operator!=(const Iterator & other) const
+		{
+			return !(*this == other);
+		}
+
+		private:
+		void
+		skipHoles()
+		{
+			while (position < table->slots.size() && !table->slots[position].present)
+				position++;
+		}
+
+		friend class ValueRangeMap;
+		TableType * table;
+		size_t	    position;
+	};
+	using iterator	     = Iterator<ValueRangeMap, value_type>;
+	using const_iterator = Iterator<const ValueRangeMap, const value_type>;
+
+	ValueRangeMap() = default;
+
+	ValueRangeMap(std::initializer_list<value_type> ranges)
+	{
+		for (const auto & range : ranges)
+			emplace(range);
+	}
+
+	iterator
+	begin()
+	{
+		return iterator(this, 0);
+	}
+
+	iterator
+	end()
+	{
+		return iterator(this, slots.size());
+	}
+
+	const_iterator
+	begin() const
+	{
+		return const_iterator(this, 0);
+	}
+
+	const_iterator
+	end() const
+	{
+		return const_iterator(this, slots.size());
+	}
+
+	iterator
+	find(llvm::Value * value)
+	{
+		auto indexIt = index.find(value);
+		if (indexIt != index.end())
+		{
+			return slots[indexIt->second].present ? iterator(this, indexIt->second) : end();
+		}
+		if (globalRanges != nullptr)
+		{
+			auto globalIt = globalRanges->find(value);
+			if (globalIt != globalRanges->end())
+				return append(value, globalIt->second);
+		}
+		return end();
+	}
+
+	/*
+	 * a global range that has not been copied yet is returned from the shared table
+	 * */
+	const_iterator
+	find(llvm::Value * value) const
+	{
+		auto indexIt = index.find(value);
+		if (indexIt != index.end())
+		{
+			return slots[indexIt->second].present ? const_iterator(this, indexIt->second) : end();
+		}
+		if (globalRanges != nullptr)
+		{
+			auto globalIt = globalRanges->find(value);
+			if (globalIt != globalRanges->end())
+				return globalIt;
+		}
+		return end();
+	}
+
+	/*
+	 * like std::map, an existing range (or the global one) is kept
+	 * */
+	std::pair<iterator, bool>
+	emplace(llvm::Value * value, const std::pair<double, double> & range)
+	{
+		auto indexIt = index.find(value);
+		if (indexIt != index.end())
+		{
+			Slot & slot = slots[indexIt->second];
+			if (slot.present)
+				return std::make_pair(iterator(this, indexIt->second), false);
+			slot.present	  = true;
+			slot.range.second = range;
+			return std::make_pair(iterator(this, indexIt->second), true);
+		}
+		if (globalRanges != nullptr)
+		{
+			auto globalIt = globalRanges->find(value);
+			if (globalIt != globalRanges->end())
+				return std::make_pair(append(value, globalIt->second), false);
+		}
+		return std::make_pair(append(value, range), true);
+	}
+
+	std::pair<iterator, bool>
+	emplace(const value_type & range)
+	{
+		return emplace(range.first, range.second);
+	}
+
+	std::pair<double, double> &
+	operator[](llvm::Value * value)
+	{
+		return emplace(value, std::make_pair(0, 0)).first->second;
+	}
+
+	/*
+	 * a global range is erased by a hole that hides it
+	 * */
+	void
+	erase(llvm::Value * value)
+	{
+		auto rangeIt = find(value);
+		if (rangeIt != end())
+			slots[rangeIt.position].present = false;
+	}
+
+	void
+	erase(iterator rangeIt)
+	{
+		slots[rangeIt.position].present = false;
+	}
+
+	void
+	reserve(size_t size)
+	{
+		index.reserve(size);
+	}
+
+	void
+	shareGlobalRanges(const ValueRangeMap * ranges)
+	{
+		globalRanges = ranges;
+	}
+
+	const ValueRangeMap *
+	getGlobalRanges() const
+	{
+		return globalRanges;
+	}
+
+	private:
+	struct Slot {
+		value_type range;
+		bool	   present;
+	};
+
+	iterator
+	append(llvm::Value * value, const std::pair<double, double> & range)
+	{
+		index[value] = slots.size();
+		slots.push_back(Slot{value_type(value, range), true});
+		return iterator(this, slots.size() - 1);
+	}
+
+	std::deque<Slot>		  slots;
+	llvm::DenseMap<llvm::Value *, size_t> index;
+	const ValueRangeMap *		  globalRanges = nullptr;
+};
+
 #ifdef __cplusplus
 extern "C" {
 #endif /* __cplusplus */
@@ -105,9 +356,111 @@ extern "C" {
 #include "newton-irPass-estimatorSynthesisBackend.h"
 #include "newton-irPass-invariantSignalAnnotation.h"
 
+typedef struct BoundInfo BoundInfo;
+
+/*
+ * the ranges of a callee analyzed in a context, i.e. the ranges of its arguments
+ * */
+typedef struct CalleeSummary {
+	BoundInfo *					    boundInfo;
+	std::pair<llvm::Value *, std::pair<double, double>> returnRange;
+} CalleeSummary;
+
+typedef std::pair<llvm::Function *, std::vector<std::pair<double, double>>> CalleeContext;
+typedef std::map<CalleeContext, CalleeSummary>				    CalleeSummaryMap;
+
+/*
+ * the clones of the callees specialized by the ranges of their arguments.
+ * The calls in the same context call the same clone, and the clones add at most `budget` instructions.
+ * */
+typedef struct Specialization {
+	std::map<CalleeContext, std::pair<llvm::Function *, CalleeSummary>> clones;
+	/*
+	 * the callee each clone is cloned from, the context of a call to a clone is the one of its callee
+	 * */
+	std::map<llvm::Function *, llvm::Function *>			     origins;
+	uint64_t							     budget;
+} Specialization;
+
+/*
+ * the ranges of the elements of an array, or of the memory a pointer argument points to.
+ * The elements are split into segments of `segmentSize` elements with one range each:
+ * a segment per element for small arrays, a segment per stride of elements for larger ones,
+ * and a single (uniform) segment if the number of elements is unknown.
+ * A segment is empty until something is stored to it.
+ * */
+typedef struct ArrayRange {
+	uint64_t				  elementSize;
+	/*
+	 * 0 if unknown
+	 * */
+	uint64_t				  elementNum;
+	uint64_t				  segmentSize;
+	std::vector<std::pair<double, double>>	  segmentRanges;
+	/*
+	 * the memory holds values we don't know, e.g. the content of a pointer argument
+	 * */
+	bool					  unknownInitial;
+	/*
+	 * something we don't track may have stored to it, e.g. a call to a declared function
+	 * */
+	bool					  unknownStores;
+} ArrayRange;
+
+/*
+ * the range of a field of a structure or union, from the sensor type of its member in the debug information.
+ * A field only gives its range to the accesses of the same size and kind (integer or floating-point),
+ * as the other members of a union reinterpret its bits.
+ * */
+typedef struct FieldRange {
+	uint64_t		  fieldSize;
+	bool			  isFloatingPoint;
+	std::pair<double, double> range;
+} FieldRange;
+
+/*
+ * the representations of a floating-point value, from the cheapest
+ * */
+typedef enum PrecisionFormat {
+	kPrecisionFixedPoint,
+	kPrecisionFloat,
+	kPrecisionDouble,
+} PrecisionFormat;
+
+/*
+ * the representation the precision analysis chooses for a floating-point value:
+ * the error it carries from the sensors, and the rounding error it may add within the error budget
+ * */
+typedef struct ValuePrecision {
+	PrecisionFormat format;
+	double		inputError;
+	double		roundingError;
+} ValuePrecision;
+
 typedef struct BoundInfo {
-	std::map<llvm::Value *, std::pair<double, double>> virtualRegisterRange;
+	ValueRangeMap			   virtualRegisterRange;
 	std::map<std::string, BoundInfo *>		   calleeBound;
+	/*
+	 * the arrays, by the alloca, global variable or argument they are based on
+	 * */
+	std::map<llvm::Value *, ArrayRange>	   arrayRange;
+	/*
+	 * the fields of the structures and unions, by their address and the byte offset of the field
+	 * */
+	std::map<std::pair<llvm::Value *, uint64_t>, FieldRange> fieldRange;
+	/*
+	 * the representations of the floating-point instructions, empty without an error budget
+	 * */
+	std::map<llvm::Value *, ValuePrecision> valuePrecision;
+	/*
+	 * the callees analyzed so far, shared by the functions analyzed together.
+	 * Calls without overloading reuse the summary of a callee in the same context.
+	 * */
+	CalleeSummaryMap *		   calleeSummary = nullptr;
+	/*
+	 * the specialized callees, shared by the functions analyzed together with overloading
+	 * */
+	Specialization *		   specialization = nullptr;
 } BoundInfo;
 
 std::pair<llvm::Value *, std::pair<double, double>>
@@ -117,6 +470,9 @@ rangeAnalysis(State * N, llvm::Function & llvmIrFunction, BoundInfo * boundInfo,
 	      const std::map<llvm::Value *, std::vector<std::pair<double, double>>> & virtualRegisterVectorRange,
 	      bool								      overLoadFunc);
 
+bool
+getValueRange(llvm::Value * value, const BoundInfo * boundInfo, std::pair<double, double> & valueRange);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif /* __cplusplus */
@@ -260,7 +260,7 @@ getShrinkDoubleType(State * N, Value * boundValue, const std::pair<double, doubl
 
 typeInfo
 getTypeInfo(State * N, Value * inValue,
-	    const std::map<llvm::Value *, std::pair<double, double>> & virtualRegisterRange)
+	    const ValueRangeMap & virtualRegisterRange)
 {
 	typeInfo typeInformation;
 	typeInformation.signFlag  = true;
@@ -579,8 +579,8 @@ isSignedValue(Value * inValue)
 
 void
 matchPhiOperandType(State * N, Instruction * inInstruction, BasicBlock & llvmIrBasicBlock,
-		    std::map<llvm::Value *, std::pair<double, double>> & virtualRegisterRange,
-		    std::map<Value *, typeInfo> &			 typeChangedInst)
+		    ValueRangeMap &		  virtualRegisterRange,
+		    std::map<Value *, typeInfo> & typeChangedInst)
 {
 	std::vector<Value *> operands;
 	for (size_t id = 0; id < inInstruction->getNumOperands(); id++)
@@ -673,8 +673,8 @@ matchPhiOperandType(State * N, Instruction * inInstruction, BasicBlock & llvmIrB
  * */
 void
 matchOperandType(State * N, Instruction * inInstruction, BasicBlock & llvmIrBasicBlock,
-		 std::map<llvm::Value *, std::pair<double, double>> & virtualRegisterRange,
-		 std::map<Value *, typeInfo> &			      typeChangedInst)
+		 ValueRangeMap &	       virtualRegisterRange,
+		 std::map<Value *, typeInfo> & typeChangedInst)
 {
 	auto leftOperand  = inInstruction->getOperand(0);
 	auto rightOperand = inInstruction->getOperand(1);
@@ -824,7 +824,7 @@ matchOperandType(State * N, Instruction * inInstruction, BasicBlock & llvmIrBasi
 			{
 				assert(false && "unknown floating type");
 			}
-			std::map<Value *, std::pair<double, double>> constOperandRange =
+			ValueRangeMap constOperandRange =
 			    {{constOperand, std::make_pair(constValue, constValue)}};
 			typeInfo realType = getTypeInfo(N, constOperand, constOperandRange);
 			if ((realType.valueType != nullptr) &&
@@ -865,7 +865,7 @@ matchOperandType(State * N, Instruction * inInstruction, BasicBlock & llvmIrBasi
 		}
 		else if (ConstantInt * constInt = llvm::dyn_cast<llvm::ConstantInt>(constOperand))
 		{
-			std::map<Value *, std::pair<double, double>> constOperandRange;
+			ValueRangeMap constOperandRange;
 			auto					     constValue = constInt->getSExtValue();
 			constOperandRange					= {{constOperand, std::make_pair(constValue, constValue)}};
 			typeInfo realType					= getTypeInfo(N, constOperand, constOperandRange);
@@ -942,8 +942,8 @@ matchOperandType(State * N, Instruction * inInstruction, BasicBlock & llvmIrBasi
  * */
 void
 matchDestType(State * N, Instruction * inInstruction, BasicBlock & llvmIrBasicBlock,
-	      std::map<llvm::Value *, std::pair<double, double>> & virtualRegisterRange,
-	      std::map<Value *, typeInfo> &			   typeChangedInst)
+	      ValueRangeMap &		    virtualRegisterRange,
+	      std::map<Value *, typeInfo> & typeChangedInst)
 {
 	typeInfo typeInformation;
 	typeInformation.valueType = nullptr;
@@ -1102,8 +1102,8 @@ shrinkStrategy(State * N, Instruction * inInstruction)
 
 bool
 shrinkInstructionType(State * N, Instruction * inInstruction, BasicBlock & llvmIrBasicBlock,
-		      std::map<llvm::Value *, std::pair<double, double>> & virtualRegisterRange,
-		      std::map<Value *, typeInfo> &			   typeChangedInst)
+		      ValueRangeMap &		    virtualRegisterRange,
+		      std::map<Value *, typeInfo> & typeChangedInst)
 {
 	bool	 changed	 = false;
 	typeInfo typeInformation = getTypeInfo(N, inInstruction, virtualRegisterRange);
@@ -1163,8 +1163,8 @@ shrinkInstructionType(State * N, Instruction * inInstruction, BasicBlock & llvmI
 
 void
 rollBackBasicBlock(State * N, BasicBlock & llvmIrBasicBlock,
-		   std::map<llvm::Value *, std::pair<double, double>> & virtualRegisterRange,
-		   std::map<Value *, typeInfo>				typeChangedInst)
+		   ValueRangeMap &	       virtualRegisterRange,
+		   std::map<Value *, typeInfo> typeChangedInst)
 {
 	for (Instruction & llvmIrInstruction : llvmIrBasicBlock)
 	{
@@ -1216,47 +1216,18 @@ rollBackStrategy(State * N, const std::vector<Value *> & depLink)
 	return willBack;
 }
 
+/*
+ * Both maps are filled with `emplace`, so an entry left behind by an erased instruction
+ * would be inherited by a new instruction allocated at the same address.
+ * */
 void
-rollBackDependencyLink(State * N, const std::vector<Value *> & depLink,
-		       std::map<llvm::Value *, std::pair<double, double>> & virtualRegisterRange,
-		       std::map<Value *, typeInfo>			    typeChangedInst)
+eraseInstruction(Instruction * llvmIrInstruction,
+		 ValueRangeMap &	       virtualRegisterRange,
+		 std::map<Value *, typeInfo> & typeChangedInst)
 {
-	for (Value * value : depLink)
-	{
-		if (Instruction * valueInst = dyn_cast<Instruction>(value))
-		{
-			/*
-			 * roll back operands
-			 * */
-			for (size_t idx = 0; idx < valueInst->getNumOperands(); idx++)
-			{
-				auto tcInstIt = typeChangedInst.find(valueInst->getOperand(idx));
-				if (tcInstIt != typeChangedInst.end())
-				{
-					auto newTypeValue = rollbackType(N, valueInst, idx, *valueInst->getParent(),
-									 typeChangedInst);
-					auto vrIt	  = virtualRegisterRange.find(valueInst->getOperand(idx));
-					if (newTypeValue != nullptr && vrIt != virtualRegisterRange.end())
-					{
-						virtualRegisterRange.emplace(newTypeValue, vrIt->second);
-					}
-				}
-			}
-		}
-		/*
-		 * roll back destination
-		 * */
-		auto tcInstIt = typeChangedInst.find(value);
-		if (tcInstIt != typeChangedInst.end())
-		{
-			value->mutateType(tcInstIt->second.valueType);
-			if (auto llvmIrAllocaInstruction = dyn_cast<AllocaInst>(value))
-			{
-				llvmIrAllocaInstruction->setAllocatedType(
-				    tcInstIt->second.valueType->getPointerElementType());
-			}
-		}
-	}
+	virtualRegisterRange.erase(llvmIrInstruction);
+	typeChangedInst.erase(llvmIrInstruction);
+	llvmIrInstruction->eraseFromParent();
 }
 
 /*
@@ -1277,7 +1248,7 @@ rollBackDependencyLink(State * N, const std::vector<Value *> & depLink,
  *  %inst = trunc bigType %srcInst to smallType
  * */
 bool matchCastType(State * N, Instruction * inInstruction, BasicBlock & llvmIrBasicBlock,
-                    std::map<llvm::Value *, std::pair<double, double>> & virtualRegisterRange,
+                    ValueRangeMap & virtualRegisterRange,
                     std::map<Value *, typeInfo> & typeChangedInst) {
     bool	 changed	 = false;
 
@@ -1333,7 +1304,7 @@ bool matchCastType(State * N, Instruction * inInstruction, BasicBlock & llvmIrBa
 
     Instruction * newCastInst = llvm::dyn_cast<llvm::Instruction>(castInst);
     inInstruction->replaceAllUsesWith(newCastInst);
-    inInstruction->removeFromParent();
+    eraseInstruction(inInstruction, virtualRegisterRange, typeChangedInst);
 
     return changed;
 }
@@ -1585,7 +1556,7 @@ shrinkInstType(State * N, BoundInfo * boundInfo, Function & llvmIrFunction)
 							ReturnInst::Create(llvmIrReturnInstruction->getContext(),
 									   castInst,
 									   llvmIrReturnInstruction->getParent());
-							llvmIrReturnInstruction->removeFromParent();
+							eraseInstruction(llvmIrReturnInstruction, boundInfo->virtualRegisterRange, typeChangedInst);
 						}
 					}
 					break;
@@ -1652,8 +1623,8 @@ shrinkInstType(State * N, BoundInfo * boundInfo, Function & llvmIrFunction)
 
 void
 mergeCast(State * N, Function & llvmIrFunction,
-	  std::map<llvm::Value *, std::pair<double, double>> & virtualRegisterRange,
-	  std::map<Value *, typeInfo> &			       typeChangedInst)
+	  ValueRangeMap &		virtualRegisterRange,
+	  std::map<Value *, typeInfo> &	typeChangedInst)
 {
 	/*
 	 * Merge the redundant cast instruction, prototype:
@@ -1696,7 +1667,7 @@ mergeCast(State * N, Function & llvmIrFunction,
 					if (sourceOp->getType() == llvmIrInstruction->getType())
 					{
 						llvmIrInstruction->replaceAllUsesWith(sourceOp);
-						llvmIrInstruction->removeFromParent();
+						eraseInstruction(llvmIrInstruction, virtualRegisterRange, typeChangedInst);
 						break;
 					}
 					auto sourceInst = llvm::dyn_cast<llvm::Instruction>(sourceOp);
@@ -1777,7 +1748,7 @@ mergeCast(State * N, Function & llvmIrFunction,
 								llvmIrInstruction->replaceAllUsesWith(newCastInst);
 								sourceInstVec.emplace_back(newCastInst);
 							}
-							llvmIrInstruction->removeFromParent();
+							eraseInstruction(llvmIrInstruction, virtualRegisterRange, typeChangedInst);
 						}
 						else
 						{
@@ -1872,161 +1843,6 @@ countCastInst(State * N, Function & llvmIrFunction)
 	return castCountVec;
 }
 
-using dpLink = std::vector<std::vector<Value *>>;
-/*
- * get the index of the node if found, or return "-1"
- * */
-int
-findNode(const dpLink & dependencyLink, Value * node)
-{
-	auto dlIt = std::find_if(dependencyLink.begin(), dependencyLink.end(), [node](const auto & v) {
-		return std::find(v.begin(), v.end(), node) != v.end();
-	});
-	if (dlIt != dependencyLink.end())
-	{
-		return std::distance(dependencyLink.begin(), dlIt);
-	}
-	else
-	{
-		return -1;
-	}
-}
-
-void
-insertLink(dpLink & dependencyLink, Value * aimNode, Value * siblingNode)
-{
-	auto aimPos	= findNode(dependencyLink, aimNode);
-	auto siblingPos = findNode(dependencyLink, siblingNode);
-	if (aimPos != -1)
-	{
-		/*aimNode in dependencyLink*/
-		if (siblingPos != -1)
-		{
-			/*
-			 * sibling is also in dependencyLink, merge them
-			 * */
-			auto newPos    = aimPos < siblingPos ? aimPos : siblingPos;
-			auto deletePos = aimPos > siblingPos ? aimPos : siblingPos;
-			dependencyLink[newPos].insert(dependencyLink[newPos].end(),
-						      dependencyLink[deletePos].begin(),
-						      dependencyLink[deletePos].end());
-			dependencyLink.erase(dependencyLink.begin() + deletePos);
-		}
-		else
-		{
-			/*
-			 * sibling is not in dependencyLink, insert to aimPos
-			 * */
-			dependencyLink[aimPos].emplace_back(siblingNode);
-		}
-	}
-	else
-	{
-		/*aimNode not in dependencyLink*/
-		if (siblingPos == -1)
-		{
-			siblingPos = dependencyLink.capacity();
-			dependencyLink.resize(siblingPos + 1);
-			dependencyLink[siblingPos].emplace_back(siblingNode);
-		}
-		dependencyLink[siblingPos].emplace_back(aimNode);
-	}
-}
-
-std::vector<std::vector<Value *>>
-getDependencyLink(State * N, Function & llvmIrFunction)
-{
-	std::vector<std::vector<Value *>> dependencyLink;
-	for (BasicBlock & llvmIrBasicBlock : llvmIrFunction)
-	{
-		for (Instruction & llvmIrInstruction : llvmIrBasicBlock)
-		{
-			switch (llvmIrInstruction.getOpcode())
-			{
-				case Instruction::Call:
-					if (auto llvmIrCallInstruction = dyn_cast<CallInst>(&llvmIrInstruction))
-					{
-						Function * calledFunction = llvmIrCallInstruction->getCalledFunction();
-						if (calledFunction == nullptr || !calledFunction->hasName() ||
-						    calledFunction->getName().empty())
-							break;
-						if (!calledFunction->getName().startswith("llvm.dbg.value") &&
-						    !calledFunction->getName().startswith("llvm.dbg.declare") &&
-						    !calledFunction->getName().startswith("llvm.dbg.label"))
-						{
-							for (size_t idx = 1; idx < llvmIrCallInstruction->getNumOperands() - 1; idx++)
-							{
-								insertLink(dependencyLink, llvmIrCallInstruction->getOperand(0),
-									   llvmIrCallInstruction->getOperand(idx));
-							}
-							insertLink(dependencyLink, llvmIrCallInstruction->getOperand(0),
-								   llvmIrCallInstruction);
-						}
-					}
-					break;
-				case Instruction::Add:
-				case Instruction::FAdd:
-				case Instruction::Sub:
-				case Instruction::FSub:
-				case Instruction::Mul:
-				case Instruction::FMul:
-				case Instruction::SDiv:
-				case Instruction::FDiv:
-				case Instruction::UDiv:
-				case Instruction::URem:
-				case Instruction::SRem:
-				case Instruction::FRem:
-				case Instruction::Shl:
-				case Instruction::LShr:
-				case Instruction::AShr:
-				case Instruction::And:
-				case Instruction::Or:
-				case Instruction::Xor:
-					/*match binary operands*/
-					insertLink(dependencyLink, llvmIrInstruction.getOperand(0),
-						   llvmIrInstruction.getOperand(1));
-				case Instruction::PHI:
-					if (isa<PHINode>(llvmIrInstruction))
-					{
-						/*match multi operands*/
-						for (size_t id = 1; id < llvmIrInstruction.getNumOperands(); id++)
-						{
-							insertLink(dependencyLink, llvmIrInstruction.getOperand(0),
-								   llvmIrInstruction.getOperand(id));
-						}
-					}
-				case Instruction::FNeg:
-				case Instruction::Load:
-				case Instruction::GetElementPtr:
-					/*match dest with operands*/
-					insertLink(dependencyLink, llvmIrInstruction.getOperand(0),
-						   &llvmIrInstruction);
-				case Instruction::FPToUI:
-				case Instruction::FPToSI:
-				case Instruction::SIToFP:
-				case Instruction::UIToFP:
-				case Instruction::ZExt:
-				case Instruction::SExt:
-				case Instruction::FPExt:
-				case Instruction::Trunc:
-				case Instruction::FPTrunc:
-				case Instruction::BitCast:
-					/*check dest*/
-					break;
-				case Instruction::Store:
-				case Instruction::ICmp:
-				case Instruction::FCmp:
-					/*match operands*/
-					insertLink(dependencyLink, llvmIrInstruction.getOperand(0),
-						   llvmIrInstruction.getOperand(1));
-				default:
-					continue;
-			}
-		}
-	}
-	return dependencyLink;
-}
-
 /*
  * There are three kinds of instructions in LLVM that are related with signed/unsigned
  *  1. nsw/nuw with Add, Sub, Mul, Shl
@@ -2039,7 +1855,7 @@ getDependencyLink(State * N, Function & llvmIrFunction)
  * */
 void
 upDateInstSignFlag(State * N, Function & llvmIrFunction,
-                   std::map<llvm::Value *, std::pair<double, double>> & virtualRegisterRange,
+                   ValueRangeMap & virtualRegisterRange,
                    std::map<Value *, typeInfo> & typeChangedInst) {
     for (BasicBlock & llvmIrBasicBlock : llvmIrFunction) {
         for (BasicBlock::iterator itBB = llvmIrBasicBlock.begin(); itBB != llvmIrBasicBlock.end();) {
@@ -2100,7 +1916,7 @@ upDateInstSignFlag(State * N, Function & llvmIrFunction,
                             Builder.SetInsertPoint(llvmIrInstruction);
                             auto UDivInst = Builder.CreateUDiv(lhs, rhs);
                             llvmIrInstruction->replaceAllUsesWith(UDivInst);
-                            llvmIrInstruction->removeFromParent();
+                            eraseInstruction(llvmIrInstruction, virtualRegisterRange, typeChangedInst);
                         }
                         break;
                     }
@@ -2111,7 +1927,7 @@ upDateInstSignFlag(State * N, Function & llvmIrFunction,
                             Builder.SetInsertPoint(llvmIrInstruction);
                             auto URemInst = Builder.CreateURem(lhs, rhs);
                             llvmIrInstruction->replaceAllUsesWith(URemInst);
-                            llvmIrInstruction->removeFromParent();
+                            eraseInstruction(llvmIrInstruction, virtualRegisterRange, typeChangedInst);
                         }
                         break;
                     }
@@ -2122,7 +1938,7 @@ upDateInstSignFlag(State * N, Function & llvmIrFunction,
                             Builder.SetInsertPoint(llvmIrInstruction);
                             auto LShrInst = Builder.CreateLShr(lhs, rhs);
                             llvmIrInstruction->replaceAllUsesWith(LShrInst);
-                            llvmIrInstruction->removeFromParent();
+                            eraseInstruction(llvmIrInstruction, virtualRegisterRange, typeChangedInst);
                         }
                         break;
                     }
@@ -2192,17 +2008,486 @@ upDateInstSignFlag(State * N, Function & llvmIrFunction,
     }
 }
 
+enum ShrinkCost {
+	/*
+	 * an instruction in a loop is assumed to run this many times per iteration of the enclosing loop
+	 * */
+	LoopIterationWeight = 8,
+	/*
+	 * a word of stack saved is worth an instruction
+	 * */
+	StackBytesPerCost = 4,
+	/*
+	 * the narrowest element an array is narrowed to
+	 * */
+	NarrowestElementBits = 8,
+};
+
+/*
+ * the target machine of a target triple, created once per triple.
+ * nullptr if the target is not registered, e.g. an empty triple.
+ * */
+TargetMachine *
+getTargetMachine(const std::string & targetTriple)
+{
+	static std::map<std::string, std::unique_ptr<TargetMachine>> targetMachines;
+	if (targetMachines.empty())
+	{
+		InitializeAllTargetInfos();
+		InitializeAllTargets();
+		InitializeAllTargetMCs();
+	}
+
+	auto tmIt = targetMachines.find(targetTriple);
+	if (tmIt != targetMachines.end())
+	{
+		return tmIt->second.get();
+	}
+	std::string    errorMessage;
+	const Target * target	     = TargetRegistry::lookupTarget(targetTriple, errorMessage);
+	TargetMachine * targetMachine = nullptr;
+	if (target != nullptr)
+	{
+		targetMachine = target->createTargetMachine(targetTriple, "generic", "", TargetOptions(), None);
+	}
+	targetMachines[targetTriple].reset(targetMachine);
+	return targetMachine;
+}
+
+/*
+ * the cost model of the target of a function, only the data layout without a registered target
+ * */
+TargetTransformInfo
+getTargetTransformInfo(Function & llvmIrFunction)
+{
+	TargetMachine * targetMachine = getTargetMachine(llvmIrFunction.getParent()->getTargetTriple());
+	return targetMachine != nullptr ? targetMachine->getTargetTransformInfo(llvmIrFunction)
+					: TargetTransformInfo(llvmIrFunction.getParent()->getDataLayout());
+}
+
+/*
+ * the bits of the fixed-width vector registers of the target, 0 without SIMD
+ * */
+unsigned
+getVectorRegisterBits(const TargetTransformInfo & targetTransformInfo)
+{
+	return targetTransformInfo.getRegisterBitWidth(TargetTransformInfo::RGK_FixedWidthVector).getFixedSize();
+}
+
+/*
+ * the lanes the loop vectorizer can use for an innermost loop: a vector register holds as many elements
+ * as fit of the widest value the loop loads or stores. 1 if the loop is not a candidate, e.g. it calls a function.
+ * */
+unsigned
+getLoopLanes(const Loop * loop, const DataLayout & dataLayout, unsigned vectorRegisterBits)
+{
+	if (vectorRegisterBits == 0 || !loop->isInnermost())
+	{
+		return 1;
+	}
+	uint64_t widestBits = 0;
+	for (BasicBlock * llvmIrBasicBlock : loop->blocks())
+	{
+		for (Instruction & llvmIrInstruction : *llvmIrBasicBlock)
+		{
+			if (auto llvmIrCallInstruction = dyn_cast<CallInst>(&llvmIrInstruction))
+			{
+				if (!isa<IntrinsicInst>(llvmIrCallInstruction))
+					return 1;
+				continue;
+			}
+			Type * accessType = nullptr;
+			if (auto llvmIrLoadInstruction = dyn_cast<LoadInst>(&llvmIrInstruction))
+				accessType = llvmIrLoadInstruction->getType();
+			else if (auto llvmIrStoreInstruction = dyn_cast<StoreInst>(&llvmIrInstruction))
+				accessType = llvmIrStoreInstruction->getValueOperand()->getType();
+			else
+				continue;
+			if (!accessType->isIntegerTy() && !accessType->isFloatingPointTy())
+				return 1;
+			widestBits = max(widestBits, dataLayout.getTypeSizeInBits(accessType).getFixedSize());
+		}
+	}
+	if (widestBits == 0)
+	{
+		return 1;
+	}
+	return max(1u, static_cast<unsigned>(vectorRegisterBits / widestBits));
+}
+
+/*
+ * the cost of a function from the cost model of its target:
+ * the reciprocal throughput of its instructions, weighted by the depth of their loops,
+ * and the bytes of its stack variables.
+ * With `isVectorizeAware`, an innermost loop costs as much per element as per vector of its lanes.
+ * Without a registered target, the cost model only knows the data layout.
+ * */
+double
+getFunctionCost(Function & llvmIrFunction, bool isVectorizeAware)
+{
+	TargetTransformInfo targetTransformInfo = getTargetTransformInfo(llvmIrFunction);
+	const DataLayout &  dataLayout		= llvmIrFunction.getParent()->getDataLayout();
+	unsigned	    vectorRegisterBits	= isVectorizeAware ? getVectorRegisterBits(targetTransformInfo) : 0;
+	DominatorTree	    dominatorTree(llvmIrFunction);
+	LoopInfo	    loopInfo(dominatorTree);
+
+	double cost = 0;
+	for (BasicBlock & llvmIrBasicBlock : llvmIrFunction)
+	{
+		double weight = std::pow(static_cast<double>(LoopIterationWeight), loopInfo.getLoopDepth(&llvmIrBasicBlock));
+		if (Loop * loop = loopInfo.getLoopFor(&llvmIrBasicBlock))
+		{
+			weight /= getLoopLanes(loop, dataLayout, vectorRegisterBits);
+		}
+		for (Instruction & llvmIrInstruction : llvmIrBasicBlock)
+		{
+			if (isa<DbgInfoIntrinsic>(llvmIrInstruction))
+				continue;
+			if (auto llvmIrAllocaInstruction = dyn_cast<AllocaInst>(&llvmIrInstruction))
+			{
+				if (llvmIrAllocaInstruction->getAllocatedType()->isSized())
+					cost += static_cast<double>(dataLayout.getTypeAllocSize(llvmIrAllocaInstruction->getAllocatedType())) /
+						StackBytesPerCost;
+				continue;
+			}
+			InstructionCost instructionCost =
+			    targetTransformInfo.getInstructionCost(&llvmIrInstruction, TargetTransformInfo::TCK_RecipThroughput);
+			if (instructionCost.isValid())
+				cost += weight * static_cast<double>(*instructionCost.getValue());
+		}
+	}
+	return cost;
+}
+
+/*
+ * the range of the values stored to a local array, from the ranges of the stored values after the analysis.
+ * The summary of the array joins the ranges seen while a loop was widened, so it's looser.
+ * Fails if the array is accessed other than by loading and storing its elements, or if a stored value has no range.
+ * */
+bool
+getArrayStoredRange(BoundInfo * boundInfo, AllocaInst * llvmIrAllocaInstruction, ArrayType * arrayType,
+		    std::pair<double, double> & storedRange)
+{
+	bool hasStored = false;
+	for (User * allocaUser : llvmIrAllocaInstruction->users())
+	{
+		auto llvmIrGetElementPtrInstruction = dyn_cast<GetElementPtrInst>(allocaUser);
+		if (llvmIrGetElementPtrInstruction == nullptr ||
+		    llvmIrGetElementPtrInstruction->getPointerOperand() != llvmIrAllocaInstruction ||
+		    llvmIrGetElementPtrInstruction->getSourceElementType() != arrayType ||
+		    llvmIrGetElementPtrInstruction->getResultElementType() != arrayType->getElementType())
+		{
+			return false;
+		}
+		for (User * elementUser : llvmIrGetElementPtrInstruction->users())
+		{
+			if (auto llvmIrLoadInstruction = dyn_cast<LoadInst>(elementUser))
+			{
+				if (llvmIrLoadInstruction->isVolatile())
+					return false;
+			}
+			else if (auto llvmIrStoreInstruction = dyn_cast<StoreInst>(elementUser))
+			{
+				std::pair<double, double> valueRange;
+				if (llvmIrStoreInstruction->isVolatile() ||
+				    llvmIrStoreInstruction->getPointerOperand() != llvmIrGetElementPtrInstruction ||
+				    llvmIrStoreInstruction->getValueOperand()->getType() != arrayType->getElementType() ||
+				    !getValueRange(llvmIrStoreInstruction->getValueOperand(), boundInfo, valueRange))
+					return false;
+				storedRange = hasStored ? std::make_pair(min(storedRange.first, valueRange.first),
+									 max(storedRange.second, valueRange.second))
+							: valueRange;
+				hasStored   = true;
+			}
+			else
+			{
+				return false;
+			}
+		}
+	}
+	return hasStored;
+}
+
+/*
+ * narrow the elements of the local integer arrays to the range of the values stored to them,
+ * so that the loop vectorizer packs more of them in a vector register, e.g. 16 lanes of i8 instead of 4 of i32.
+ * An array is narrowed to the narrowest width whose vector is legal on the target;
+ * its loads extend the narrow elements back and its stores truncate the values.
+ * Returns whether an array is narrowed.
+ * */
+bool
+narrowArrays(State * N, BoundInfo * boundInfo, Function & llvmIrFunction)
+{
+	TargetTransformInfo targetTransformInfo = getTargetTransformInfo(llvmIrFunction);
+	const DataLayout &  dataLayout		= llvmIrFunction.getParent()->getDataLayout();
+	unsigned	    vectorRegisterBits	= getVectorRegisterBits(targetTransformInfo);
+	if (vectorRegisterBits == 0)
+	{
+		return false;
+	}
+
+	std::vector<AllocaInst *> arrayAllocas;
+	for (Instruction & llvmIrInstruction : llvmIrFunction.getEntryBlock())
+	{
+		auto llvmIrAllocaInstruction = dyn_cast<AllocaInst>(&llvmIrInstruction);
+		if (llvmIrAllocaInstruction == nullptr || llvmIrAllocaInstruction->isArrayAllocation())
+			continue;
+		auto arrayType = dyn_cast<ArrayType>(llvmIrAllocaInstruction->getAllocatedType());
+		if (arrayType != nullptr && arrayType->getElementType()->isIntegerTy())
+			arrayAllocas.emplace_back(llvmIrAllocaInstruction);
+	}
+
+	bool isNarrowed = false;
+	for (AllocaInst * llvmIrAllocaInstruction : arrayAllocas)
+	{
+		auto			  arrayType = cast<ArrayType>(llvmIrAllocaInstruction->getAllocatedType());
+		std::pair<double, double> elementRange;
+		if (!getArrayStoredRange(boundInfo, llvmIrAllocaInstruction, arrayType, elementRange))
+		{
+			continue;
+		}
+		auto	      elementType = cast<IntegerType>(arrayType->getElementType());
+		bool	      isSigned	  = elementRange.first < 0;
+		IntegerType * narrowType  = nullptr;
+		for (unsigned bits = NarrowestElementBits; bits < elementType->getBitWidth() && bits < vectorRegisterBits; bits *= 2)
+		{
+			double lowerBound = isSigned ? -std::ldexp(1.0, bits - 1) : 0;
+			double upperBound = isSigned ? std::ldexp(1.0, bits - 1) - 1 : std::ldexp(1.0, bits) - 1;
+			if (elementRange.first < lowerBound || elementRange.second > upperBound)
+				continue;
+			IntegerType * candidateType = IntegerType::get(llvmIrFunction.getContext(), bits);
+			if (targetTransformInfo.isTypeLegal(FixedVectorType::get(candidateType, vectorRegisterBits / bits)))
+			{
+				narrowType = candidateType;
+				break;
+			}
+		}
+		if (narrowType == nullptr)
+		{
+			continue;
+		}
+		isNarrowed = true;
+		flexprint(N->Fe, N->Fm, N->Fpinfo, "\tnarrow array: %s from i%u to i%u\n",
+			  llvmIrAllocaInstruction->getName().str().c_str(), elementType->getBitWidth(), narrowType->getBitWidth());
+
+		ArrayType *  narrowArrayType = ArrayType::get(narrowType, arrayType->getNumElements());
+		IRBuilder<>  Builder(llvmIrAllocaInstruction);
+		AllocaInst * narrowAllocaInstruction = Builder.CreateAlloca(narrowArrayType);
+		Align	     narrowAlign	     = dataLayout.getABITypeAlign(narrowType);
+
+		std::vector<User *> allocaUsers(llvmIrAllocaInstruction->user_begin(), llvmIrAllocaInstruction->user_end());
+		for (User * allocaUser : allocaUsers)
+		{
+			auto llvmIrGetElementPtrInstruction = cast<GetElementPtrInst>(allocaUser);
+			Builder.SetInsertPoint(llvmIrGetElementPtrInstruction);
+			std::vector<Value *> indexValues(llvmIrGetElementPtrInstruction->idx_begin(), llvmIrGetElementPtrInstruction->idx_end());
+			Value *		     narrowElement = llvmIrGetElementPtrInstruction->isInBounds()
+							     ? Builder.CreateInBoundsGEP(narrowArrayType, narrowAllocaInstruction, indexValues)
+							     : Builder.CreateGEP(narrowArrayType, narrowAllocaInstruction, indexValues);
+
+			std::vector<User *> elementUsers(llvmIrGetElementPtrInstruction->user_begin(), llvmIrGetElementPtrInstruction->user_end());
+			for (User * elementUser : elementUsers)
+			{
+				auto llvmIrInstruction = cast<Instruction>(elementUser);
+				Builder.SetInsertPoint(llvmIrInstruction);
+				if (auto llvmIrLoadInstruction = dyn_cast<LoadInst>(llvmIrInstruction))
+				{
+					LoadInst * narrowLoad  = Builder.CreateAlignedLoad(narrowType, narrowElement, narrowAlign);
+					Value *	   extendValue = Builder.CreateIntCast(narrowLoad, elementType, isSigned);
+					auto	   vrIt	       = boundInfo->virtualRegisterRange.find(llvmIrLoadInstruction);
+					if (vrIt != boundInfo->virtualRegisterRange.end())
+					{
+						boundInfo->virtualRegisterRange.emplace(narrowLoad, vrIt->second);
+						boundInfo->virtualRegisterRange.emplace(extendValue, vrIt->second);
+						boundInfo->virtualRegisterRange.erase(vrIt);
+					}
+					extendValue->takeName(llvmIrLoadInstruction);
+					llvmIrLoadInstruction->replaceAllUsesWith(extendValue);
+				}
+				else
+				{
+					Value * storeValue    = cast<StoreInst>(llvmIrInstruction)->getValueOperand();
+					Value * truncateValue = Builder.CreateIntCast(storeValue, narrowType, isSigned);
+					auto	vrIt	      = boundInfo->virtualRegisterRange.find(storeValue);
+					if (vrIt != boundInfo->virtualRegisterRange.end() && !isa<llvm::Constant>(truncateValue))
+					{
+						boundInfo->virtualRegisterRange.emplace(truncateValue, vrIt->second);
+					}
+					Builder.CreateAlignedStore(truncateValue, narrowElement, narrowAlign);
+				}
+				boundInfo->virtualRegisterRange.erase(llvmIrInstruction);
+				llvmIrInstruction->eraseFromParent();
+			}
+			boundInfo->virtualRegisterRange.erase(llvmIrGetElementPtrInstruction);
+			narrowElement->takeName(llvmIrGetElementPtrInstruction);
+			llvmIrGetElementPtrInstruction->eraseFromParent();
+		}
+
+		auto arIt = boundInfo->arrayRange.find(llvmIrAllocaInstruction);
+		if (arIt != boundInfo->arrayRange.end())
+		{
+			ArrayRange narrowArrayRange  = arIt->second;
+			narrowArrayRange.elementSize = dataLayout.getTypeAllocSize(narrowType);
+			boundInfo->arrayRange.erase(arIt);
+			boundInfo->arrayRange.emplace(narrowAllocaInstruction, narrowArrayRange);
+		}
+		narrowAllocaInstruction->takeName(llvmIrAllocaInstruction);
+		boundInfo->virtualRegisterRange.erase(llvmIrAllocaInstruction);
+		llvmIrAllocaInstruction->eraseFromParent();
+	}
+	return isNarrowed;
+}
+
+/*
+ * a copy of a function body, with the ranges of its values, to roll a transformation back to
+ * */
+typedef struct FunctionBackup {
+	Function *						   function;
+	std::vector<std::pair<Value *, std::pair<double, double>>> virtualRegisterRange;
+	std::vector<std::pair<Value *, ArrayRange>>		   arrayRange;
+} FunctionBackup;
+
+FunctionBackup
+backUpFunction(BoundInfo * boundInfo, Function & llvmIrFunction)
+{
+	FunctionBackup	  backup;
+	backup.function = Function::Create(llvmIrFunction.getFunctionType(), llvmIrFunction.getLinkage(),
+					   llvmIrFunction.getName());
+	ValueToValueMapTy valueMap;
+	for (size_t idx = 0; idx < llvmIrFunction.arg_size(); idx++)
+	{
+		valueMap[llvmIrFunction.getArg(idx)] = backup.function->getArg(idx);
+	}
+	/*
+	 * the copy keeps the debug information of the function instead of a copy of its subprogram
+	 * */
+	if (DISubprogram * subprogram = llvmIrFunction.getSubprogram())
+	{
+		valueMap.MD()[subprogram].reset(subprogram);
+	}
+	SmallVector<ReturnInst *, 8> returnInstructions;
+	CloneFunctionInto(backup.function, &llvmIrFunction, valueMap, CloneFunctionChangeType::LocalChangesOnly,
+			  returnInstructions);
+	for (const auto & vmPair : valueMap)
+	{
+		auto vrIt = boundInfo->virtualRegisterRange.find(const_cast<Value *>(vmPair.first));
+		if (vrIt != boundInfo->virtualRegisterRange.end())
+		{
+			backup.virtualRegisterRange.emplace_back(vmPair.second, vrIt->second);
+		}
+		auto arIt = boundInfo->arrayRange.find(const_cast<Value *>(vmPair.first));
+		if (arIt != boundInfo->arrayRange.end())
+		{
+			backup.arrayRange.emplace_back(vmPair.second, arIt->second);
+		}
+	}
+	return backup;
+}
+
+/*
+ * replace the body of the function by the copy, or only drop the copy if the body is kept
+ * */
+void
+restoreFunction(BoundInfo * boundInfo, Function & llvmIrFunction, FunctionBackup & backup, bool isRolledBack)
+{
+	if (!isRolledBack)
+	{
+		backup.function->dropAllReferences();
+		delete backup.function;
+		return;
+	}
+	/*
+	 * the discarded body's ranges must not outlive it
+	 * */
+	for (BasicBlock & llvmIrBasicBlock : llvmIrFunction)
+	{
+		for (Instruction & llvmIrInstruction : llvmIrBasicBlock)
+		{
+			boundInfo->virtualRegisterRange.erase(&llvmIrInstruction);
+			boundInfo->arrayRange.erase(&llvmIrInstruction);
+		}
+		llvmIrBasicBlock.dropAllReferences();
+	}
+	while (!llvmIrFunction.empty())
+	{
+		llvmIrFunction.begin()->eraseFromParent();
+	}
+	llvmIrFunction.getBasicBlockList().splice(llvmIrFunction.end(), backup.function->getBasicBlockList());
+	for (size_t idx = 0; idx < llvmIrFunction.arg_size(); idx++)
+	{
+		backup.function->getArg(idx)->replaceAllUsesWith(llvmIrFunction.getArg(idx));
+	}
+	for (auto & brPair : backup.virtualRegisterRange)
+	{
+		if (isa<Argument>(brPair.first))
+			continue;
+		boundInfo->virtualRegisterRange.emplace(brPair.first, brPair.second);
+	}
+	for (auto & barPair : backup.arrayRange)
+	{
+		boundInfo->arrayRange[barPair.first] = barPair.second;
+	}
+	delete backup.function;
+}
+
 void
 shrinkType(State * N, BoundInfo * boundInfo, Function & llvmIrFunction)
 {
 	/*
-	 * 1. construct instruction dependency link
-	 * 2. work with roll back strategies
+	 * 1. narrow the arrays for the loop vectorizer,
+	 *    and roll the narrowing back if it doesn't pay off in the cost model of the target
+	 * 2. keep a copy of the function body, with the ranges of its values,
+	 *    then shrink the types and merge the casts
+	 * 3. roll back to the copy if the shrinkage doesn't pay off in the cost model of the target,
+	 *    e.g. the casts between the narrow and the wide values cost more than the narrow operations save,
+	 *    or if the shrunk function is broken
+	 *
+	 * The cost is only checked for the function as a whole, so each step is kept or rolled back as a whole:
+	 * the values whose shrinkage pays off are rolled back with the ones whose casts cost more.
 	 * */
-    std::map<Value *, typeInfo> typeChangedInst = shrinkInstType(N, boundInfo, llvmIrFunction);
+	if (llvmIrFunction.isDeclaration())
+	{
+		return;
+	}
+	double originalCost = getFunctionCost(llvmIrFunction, N->llvmIRVectorizeShrink);
+	if (N->llvmIRVectorizeShrink)
+	{
+		FunctionBackup narrowBackup = backUpFunction(boundInfo, llvmIrFunction);
+		bool	       isNarrowed   = narrowArrays(N, boundInfo, llvmIrFunction);
+		double	       narrowCost   = isNarrowed ? getFunctionCost(llvmIrFunction, true) : originalCost;
+		/*
+		 * the extensions after the narrow loads and the truncations before the narrow stores
+		 * only pay off if the loops of the array get more lanes
+		 * */
+		bool isRolledBack = isNarrowed && (verifyFunction(llvmIrFunction) || narrowCost > originalCost);
+		if (isNarrowed)
+			flexprint(N->Fe, N->Fm, N->Fpinfo, "\tnarrow arrays: %s, cost %f -> %f%s\n",
+				  llvmIrFunction.getName().str().c_str(), originalCost, narrowCost,
+				  isRolledBack ? ", roll back" : "");
+		restoreFunction(boundInfo, llvmIrFunction, narrowBackup, isRolledBack);
+		if (isNarrowed && !isRolledBack)
+			originalCost = narrowCost;
+	}
+
+	FunctionBackup shrinkBackup = backUpFunction(boundInfo, llvmIrFunction);
+
+	std::map<Value *, typeInfo> typeChangedInst = shrinkInstType(N, boundInfo, llvmIrFunction);
 
 	mergeCast(N, llvmIrFunction, boundInfo->virtualRegisterRange, typeChangedInst);
 
-    upDateInstSignFlag(N, llvmIrFunction, boundInfo->virtualRegisterRange, typeChangedInst);
+	upDateInstSignFlag(N, llvmIrFunction, boundInfo->virtualRegisterRange, typeChangedInst);
+
+	std::string	   verifierMessage;
+	raw_string_ostream verifierStream(verifierMessage);
+	bool		   isBroken   = verifyFunction(llvmIrFunction, &verifierStream);
+	double		   shrunkCost = isBroken ? 0 : getFunctionCost(llvmIrFunction, N->llvmIRVectorizeShrink);
+	flexprint(N->Fe, N->Fm, N->Fpinfo, "\tshrink type: %s, cost %f -> %f\n", llvmIrFunction.getName().str().c_str(),
+		  originalCost, shrunkCost);
+	if (isBroken)
+		flexprint(N->Fe, N->Fm, N->Fperr, "\tshrink type: %s is broken after the shrinkage, roll back:\n%s",
+			  llvmIrFunction.getName().str().c_str(), verifierStream.str().c_str());
+	else if (shrunkCost > originalCost)
+		flexprint(N->Fe, N->Fm, N->Fpinfo, "\tshrink type: roll back %s\n", llvmIrFunction.getName().str().c_str());
+	restoreFunction(boundInfo, llvmIrFunction, shrinkBackup, isBroken || shrunkCost > originalCost);
 }
 }
@@ -52,14 +52,31 @@ enum CmpRes {
 CmpRes
 compareFCmpWithVariableRange(FCmpInst * llvmIrFCmpInstruction, double leftVariableLowerBound,
 			     double leftVariableUpperBound,
-			     double rightVariableLowerBound, double rightVariableUpperBound)
+			     double rightVariableLowerBound, double rightVariableUpperBound,
+			     bool neverNaN)
 {
+	/*
+	 * an ordered comparison is false for NaN and an unordered one is true,
+	 * so if an operand may be NaN, the ranges only decide the other outcome
+	 * */
+	if (!neverNaN)
+	{
+		CmpRes cmpRes = compareFCmpWithVariableRange(llvmIrFCmpInstruction, leftVariableLowerBound, leftVariableUpperBound,
+							     rightVariableLowerBound, rightVariableUpperBound, true);
+		if (CmpInst::isOrdered(llvmIrFCmpInstruction->getPredicate()))
+			return cmpRes == CmpRes::AlwaysTrue ? CmpRes::Depends : cmpRes;
+		return cmpRes == CmpRes::AlwaysFalse ? CmpRes::Depends : cmpRes;
+	}
 	switch (llvmIrFCmpInstruction->getPredicate())
 	{
 		case FCmpInst::FCMP_TRUE:
 			return CmpRes::AlwaysTrue;
 		case FCmpInst::FCMP_FALSE:
 			return CmpRes::AlwaysFalse;
+		case FCmpInst::FCMP_ORD:
+			return CmpRes::AlwaysTrue;
+		case FCmpInst::FCMP_UNO:
+			return CmpRes::AlwaysFalse;
 			/*
 			 * Ordered means that neither operand is a QNAN while unordered means that either operand may be a QNAN.
 			 * More details in https://llvm.org/docs/LangRef.html#fcmp-instruction
@@ -159,6 +176,32 @@ compareFCmpWithVariableRange(FCmpInst * llvmIrFCmpInstruction, double leftVariab
 	}
 }
 
+/*
+ * `x op x`: the predicates that are true (or false) when equal hold for a NaN as well,
+ * the others only fold when `x` is never a NaN, e.g. `x != x` is the test of NaN
+ * */
+CmpRes
+compareFCmpWithItself(FCmpInst * llvmIrFCmpInstruction, bool neverNaN)
+{
+	CmpInst::Predicate predicate = llvmIrFCmpInstruction->getPredicate();
+	if (CmpInst::isTrueWhenEqual(predicate))
+	{
+		return CmpRes::AlwaysTrue;
+	}
+	else if (CmpInst::isFalseWhenEqual(predicate))
+	{
+		return CmpRes::AlwaysFalse;
+	}
+	else if (neverNaN)
+	{
+		return CmpInst::isOrdered(predicate) ? CmpRes::AlwaysTrue : CmpRes::AlwaysFalse;
+	}
+	else
+	{
+		return CmpRes::Depends;
+	}
+}
+
 CmpRes
 compareICmpWithVariableRange(ICmpInst * llvmIrICmpInstruction, double leftVariableLowerBound,
 			     double leftVariableUpperBound,
@@ -284,6 +327,328 @@ getTrue(Type * Ty)
 	return ConstantInt::getTrue(Ty);
 }
 
+/*
+ * the bit patterns an integer may hold, as a few disjoint pieces.
+ * The bits of a floating-point value grow with its magnitude within each sign,
+ * so a range of values across zero gives a piece for each sign instead of all the patterns in between.
+ * */
+typedef std::vector<ConstantRange> BitsRange;
+
+enum BitsRangeLimit {
+	/*
+	 * instructions followed back from a comparison to the floating-point value whose bits it tests
+	 * */
+	MaxBitsRangeDepth  = 8,
+	/*
+	 * pieces kept before they are joined into one
+	 * */
+	MaxBitsRangePieces = 8,
+};
+
+static void
+addBitsRangePiece(BitsRange & bitsRange, const ConstantRange & piece)
+{
+	if (piece.isEmptySet())
+	{
+		return;
+	}
+	if (bitsRange.size() < BitsRangeLimit::MaxBitsRangePieces)
+	{
+		bitsRange.push_back(piece);
+		return;
+	}
+	ConstantRange joinedPiece = piece;
+	for (const auto & bitsRangePiece : bitsRange)
+	{
+		joinedPiece = joinedPiece.unionWith(bitsRangePiece);
+	}
+	bitsRange.assign(1, joinedPiece);
+}
+
+/*
+ * the bits of the values of a float or double in `valueRange`, e.g. for `asuint(x)` or the words of `x` in a union.
+ * The range doesn't cover NaN or the infinities, so only a value known to be neither has these bits,
+ * and zero may be -0.0.
+ * */
+static bool
+getFloatRangeBits(Type * floatType, const std::pair<double, double> & valueRange, BitsRange & bitsRange)
+{
+	if ((!floatType->isFloatTy() && !floatType->isDoubleTy()) ||
+	    !std::isfinite(valueRange.first) || !std::isfinite(valueRange.second) ||
+	    valueRange.first > valueRange.second)
+	{
+		return false;
+	}
+	/*
+	 * a magnitude rounds away from the range when it is converted to float
+	 * */
+	auto getMagnitudeBits = [floatType](double magnitude, bool isUpperBound) {
+		APFloat magnitudeValue(magnitude);
+		if (floatType->isFloatTy())
+		{
+			bool losesInfo;
+			magnitudeValue.convert(APFloat::IEEEsingle(),
+					       isUpperBound ? APFloat::rmTowardPositive : APFloat::rmTowardNegative, &losesInfo);
+		}
+		return magnitudeValue.bitcastToAPInt();
+	};
+	bitsRange.clear();
+	if (valueRange.second >= 0)
+	{
+		addBitsRangePiece(bitsRange, ConstantRange::getNonEmpty(getMagnitudeBits(valueRange.first > 0 ? valueRange.first : 0, false),
+									getMagnitudeBits(valueRange.second, true) + 1));
+	}
+	if (valueRange.first <= 0)
+	{
+		APInt signBit = APInt::getSignMask(floatType->getPrimitiveSizeInBits());
+		addBitsRangePiece(bitsRange, ConstantRange::getNonEmpty(signBit | getMagnitudeBits(valueRange.second < 0 ? -valueRange.second : 0, false),
+									(signBit | getMagnitudeBits(-valueRange.first, true)) + 1));
+	}
+	return true;
+}
+
+/*
+ * the range of a floating-point value, or of the value passed for it if it's an argument of a callee.
+ * Like the NaN tests of the comparisons, the bits are only decided if the value is never NaN nor infinite.
+ * */
+static bool
+getFloatBitsRange(Value * value, const BoundInfo * boundInfo, const std::map<Value *, Value *> & arguments, BitsRange & bitsRange)
+{
+	auto			  argumentIt = arguments.find(value);
+	Value *			  rangeValue = argumentIt != arguments.end() ? argumentIt->second : value;
+	std::pair<double, double> valueRange;
+	return isKnownNeverNaN(rangeValue, nullptr) && isKnownNeverInfinity(rangeValue, nullptr) &&
+	       getValueRange(rangeValue, boundInfo, valueRange) && getFloatRangeBits(value->getType(), valueRange, bitsRange);
+}
+
+/*
+ * the bits of the floating-point value stored to the memory a load reads, e.g.
+ *   store double %x, double* %x.addr
+ *   %0 = bitcast double* %x.addr to i32*
+ *   %add.ptr = getelementptr inbounds i32, i32* %0, i64 1
+ *   %1 = load i32, i32* %add.ptr
+ * for `__HI(x)`. Only a store earlier in the same basic block with nothing written in between is used.
+ * */
+static bool
+getLoadBitsRange(LoadInst * llvmIrLoadInstruction, const BoundInfo * boundInfo, const std::map<Value *, Value *> & arguments,
+		 BitsRange & bitsRange)
+{
+	StoreInst * llvmIrStoreInstruction = nullptr;
+	for (auto it = ++llvmIrLoadInstruction->getReverseIterator(); it != llvmIrLoadInstruction->getParent()->rend(); it++)
+	{
+		llvmIrStoreInstruction = dyn_cast<StoreInst>(&*it);
+		if (llvmIrStoreInstruction != nullptr || it->mayWriteToMemory())
+		{
+			break;
+		}
+	}
+	if (llvmIrStoreInstruction == nullptr || llvmIrStoreInstruction->isVolatile() || llvmIrLoadInstruction->isVolatile() ||
+	    !llvmIrLoadInstruction->getType()->isIntegerTy())
+	{
+		return false;
+	}
+	auto & dataLayout = llvmIrLoadInstruction->getModule()->getDataLayout();
+	APInt  loadOffset(dataLayout.getIndexTypeSizeInBits(llvmIrLoadInstruction->getPointerOperandType()), 0);
+	APInt  storeOffset(loadOffset.getBitWidth(), 0);
+	auto   loadBase	   = llvmIrLoadInstruction->getPointerOperand()->stripAndAccumulateConstantOffsets(dataLayout, loadOffset, true);
+	auto   storeBase   = llvmIrStoreInstruction->getPointerOperand()->stripAndAccumulateConstantOffsets(dataLayout, storeOffset, true);
+	auto   storedValue = llvmIrStoreInstruction->getValueOperand();
+	if (storeBase != loadBase)
+	{
+		return false;
+	}
+	/*
+	 * the load reads a word inside the stored value
+	 * */
+	int64_t	 wordOffset = (loadOffset - storeOffset).getSExtValue();
+	uint64_t storeSize  = dataLayout.getTypeStoreSize(storedValue->getType());
+	uint64_t loadSize   = dataLayout.getTypeStoreSize(llvmIrLoadInstruction->getType());
+	BitsRange storedBitsRange;
+	if (wordOffset < 0 || wordOffset + loadSize > storeSize ||
+	    !getFloatBitsRange(storedValue, boundInfo, arguments, storedBitsRange))
+	{
+		return false;
+	}
+	uint64_t      shiftBits = (dataLayout.isLittleEndian() ? wordOffset : storeSize - wordOffset - loadSize) * 8;
+	ConstantRange shift(APInt(storeSize * 8, shiftBits));
+	bitsRange.clear();
+	for (const auto & piece : storedBitsRange)
+	{
+		addBitsRangePiece(bitsRange, piece.lshr(shift).truncate(llvmIrLoadInstruction->getType()->getIntegerBitWidth()));
+	}
+	return true;
+}
+
+/*
+ * the bits of an integer computed from the bits of a floating-point value, e.g. `hx & 0x7fffffff` for `hx = __HI(x)`,
+ * or `abstop12(x)` that calls `asuint(x)`. The arguments of a callee are mapped to the values passed by the call.
+ * */
+static bool
+getBitsRange(Value * value, const BoundInfo * boundInfo, const std::map<Value *, Value *> & arguments,
+	     unsigned depth, BitsRange & bitsRange)
+{
+	auto argumentIt = arguments.find(value);
+	if (argumentIt != arguments.end())
+	{
+		value = argumentIt->second;
+	}
+	if (auto constInt = dyn_cast<ConstantInt>(value))
+	{
+		bitsRange.assign(1, ConstantRange(constInt->getValue()));
+		return true;
+	}
+	auto llvmIrInstruction = dyn_cast<Instruction>(value);
+	if (llvmIrInstruction == nullptr || depth >= BitsRangeLimit::MaxBitsRangeDepth || !value->getType()->isIntegerTy())
+	{
+		return false;
+	}
+	BitsRange operandBitsRange;
+	bitsRange.clear();
+	switch (llvmIrInstruction->getOpcode())
+	{
+		case Instruction::BitCast:
+			return getFloatBitsRange(llvmIrInstruction->getOperand(0), boundInfo, arguments, bitsRange);
+
+		case Instruction::Load:
+			return getLoadBitsRange(cast<LoadInst>(llvmIrInstruction), boundInfo, arguments, bitsRange);
+
+		case Instruction::LShr:
+		case Instruction::And:
+		{
+			auto constInt = dyn_cast<ConstantInt>(llvmIrInstruction->getOperand(1));
+			if (constInt == nullptr ||
+			    !getBitsRange(llvmIrInstruction->getOperand(0), boundInfo, arguments, depth + 1, operandBitsRange))
+			{
+				return false;
+			}
+			const APInt & constValue = constInt->getValue();
+			for (const auto & piece : operandBitsRange)
+			{
+				if (llvmIrInstruction->getOpcode() == Instruction::LShr)
+				{
+					addBitsRangePiece(bitsRange, piece.lshr(ConstantRange(constValue)));
+					continue;
+				}
+				/*
+				 * a mask of the low bits keeps the order of the values that agree on the high bits,
+				 * e.g. clearing the sign bit gives the bits of the magnitude
+				 * */
+				APInt lowerBound = piece.getUnsignedMin(), upperBound = piece.getUnsignedMax();
+				if (constValue.isMask() &&
+				    lowerBound.lshr(constValue.countTrailingOnes()) == upperBound.lshr(constValue.countTrailingOnes()))
+				{
+					addBitsRangePiece(bitsRange, ConstantRange::getNonEmpty(lowerBound & constValue, (upperBound & constValue) + 1));
+				}
+				else
+				{
+					addBitsRangePiece(bitsRange, ConstantRange::getNonEmpty(APInt::getZero(constValue.getBitWidth()),
+												APIntOps::umin(upperBound, constValue) + 1));
+				}
+			}
+			return true;
+		}
+
+		case Instruction::Trunc:
+		case Instruction::ZExt:
+		{
+			if (!getBitsRange(llvmIrInstruction->getOperand(0), boundInfo, arguments, depth + 1, operandBitsRange))
+			{
+				return false;
+			}
+			unsigned bitWidth = value->getType()->getIntegerBitWidth();
+			for (const auto & piece : operandBitsRange)
+			{
+				addBitsRangePiece(bitsRange, llvmIrInstruction->getOpcode() == Instruction::Trunc ? piece.truncate(bitWidth)
+														  : piece.zeroExtend(bitWidth));
+			}
+			return true;
+		}
+
+		case Instruction::PHI:
+			for (auto & incomingValue : cast<PHINode>(llvmIrInstruction)->incoming_values())
+			{
+				if (!getBitsRange(incomingValue, boundInfo, arguments, depth + 1, operandBitsRange))
+				{
+					return false;
+				}
+				for (const auto & piece : operandBitsRange)
+				{
+					addBitsRangePiece(bitsRange, piece);
+				}
+			}
+			return true;
+
+		case Instruction::Call:
+		{
+			/*
+			 * the bits returned by a callee like `asuint()`, from the values passed to it
+			 * */
+			auto llvmIrCallInstruction = cast<CallInst>(llvmIrInstruction);
+			auto calledFunction	   = llvmIrCallInstruction->getCalledFunction();
+			if (calledFunction == nullptr || calledFunction->isDeclaration() || calledFunction->isVarArg())
+			{
+				return false;
+			}
+			std::map<Value *, Value *> calleeArguments;
+			for (auto & calleeArgument : calledFunction->args())
+			{
+				Value * passedValue	     = llvmIrCallInstruction->getArgOperand(calleeArgument.getArgNo());
+				auto	passedArgumentIt = arguments.find(passedValue);
+				calleeArguments.emplace(&calleeArgument, passedArgumentIt != arguments.end() ? passedArgumentIt->second : passedValue);
+			}
+			for (auto & calleeBasicBlock : *calledFunction)
+			{
+				auto llvmIrReturnInstruction = dyn_cast<ReturnInst>(calleeBasicBlock.getTerminator());
+				if (llvmIrReturnInstruction == nullptr)
+				{
+					continue;
+				}
+				if (!getBitsRange(llvmIrReturnInstruction->getReturnValue(), boundInfo, calleeArguments, depth + 1, operandBitsRange))
+				{
+					return false;
+				}
+				for (const auto & piece : operandBitsRange)
+				{
+					addBitsRangePiece(bitsRange, piece);
+				}
+			}
+			return !bitsRange.empty();
+		}
+
+		default:
+			return false;
+	}
+}
+
+/*
+ * decide the tests of the bits of floating-point values in the math library, e.g. in `__ieee754_exp()`:
+ *   hx = __HI(x) & 0x7fffffff;
+ *   if (hx >= 0x7ff00000) ... // NaN or Inf
+ * The comparison is decided if it holds, or doesn't hold, for every pair of pieces of the operands.
+ * */
+static CmpRes
+compareICmpWithBitsRange(ICmpInst * llvmIrICmpInstruction, const BoundInfo * boundInfo)
+{
+	std::map<Value *, Value *> arguments;
+	BitsRange		   leftBitsRange, rightBitsRange;
+	if (!getBitsRange(llvmIrICmpInstruction->getOperand(0), boundInfo, arguments, 0, leftBitsRange) ||
+	    !getBitsRange(llvmIrICmpInstruction->getOperand(1), boundInfo, arguments, 0, rightBitsRange) ||
+	    leftBitsRange.empty() || rightBitsRange.empty())
+	{
+		return CmpRes::Unsupported;
+	}
+	bool alwaysTrue = true, alwaysFalse = true;
+	for (const auto & leftPiece : leftBitsRange)
+	{
+		for (const auto & rightPiece : rightBitsRange)
+		{
+			alwaysTrue &= leftPiece.icmp(llvmIrICmpInstruction->getPredicate(), rightPiece);
+			alwaysFalse &= leftPiece.icmp(llvmIrICmpInstruction->getInversePredicate(), rightPiece);
+		}
+	}
+	return alwaysTrue ? CmpRes::AlwaysTrue : (alwaysFalse ? CmpRes::AlwaysFalse : CmpRes::Depends);
+}
+
 bool
 simplifyControlFlow(State * N, BoundInfo * boundInfo, Function & llvmIrFunction)
 {
@@ -292,11 +657,43 @@ simplifyControlFlow(State * N, BoundInfo * boundInfo, Function & llvmIrFunction)
 	{
 		for (Instruction & llvmIrInstruction : llvmIrBasicBlock)
 		{
+			/*
+			 * rangeAnalysis() has already decided the comparisons that always or never hold
+			 * with the operand ranges restricted by the dominating branches
+			 * */
+			if (isa<CmpInst>(llvmIrInstruction) && llvmIrInstruction.getType()->isIntegerTy(1) && !llvmIrInstruction.use_empty())
+			{
+				auto vrRangeIt = boundInfo->virtualRegisterRange.find(&llvmIrInstruction);
+				if (vrRangeIt != boundInfo->virtualRegisterRange.end() &&
+				    vrRangeIt->second.first == vrRangeIt->second.second)
+				{
+					flexprint(N->Fe, N->Fm, N->Fpinfo, "\tCmp: the comparison result is %f\n",
+						  vrRangeIt->second.first);
+					llvmIrInstruction.replaceAllUsesWith(vrRangeIt->second.first != 0 ? getTrue(llvmIrInstruction.getType())
+													  : getFalse(llvmIrInstruction.getType()));
+					changed = true;
+					continue;
+				}
+			}
 			switch (llvmIrInstruction.getOpcode())
 			{
 				case Instruction::ICmp:
 					if (auto llvmIrICmpInstruction = dyn_cast<ICmpInst>(&llvmIrInstruction))
 					{
+						/*
+						 * the bits of a floating-point value, e.g. the exponent tested for NaN, Inf or subnormal values
+						 * */
+						CmpRes bitsCompareResult = compareICmpWithBitsRange(llvmIrICmpInstruction, boundInfo);
+						if (bitsCompareResult == CmpRes::AlwaysTrue || bitsCompareResult == CmpRes::AlwaysFalse)
+						{
+							flexprint(N->Fe, N->Fm, N->Fpinfo, "\tICmp: the comparison result of the bits is %d\n",
+								  bitsCompareResult);
+							Type * retTy = GetCompareTy(llvmIrICmpInstruction->getOperand(0));
+							llvmIrICmpInstruction->replaceAllUsesWith(bitsCompareResult == CmpRes::AlwaysTrue ? getTrue(retTy)
+																	      : getFalse(retTy));
+							changed = true;
+							break;
+						}
 						auto leftOperand  = llvmIrICmpInstruction->getOperand(0);
 						auto rightOperand = llvmIrICmpInstruction->getOperand(1);
 						if ((isa<llvm::Constant>(leftOperand) && !isa<llvm::Constant>(rightOperand)))
@@ -442,11 +839,16 @@ simplifyControlFlow(State * N, BoundInfo * boundInfo, Function & llvmIrFunction)
 								flexprint(N->Fe, N->Fm, N->Fpinfo,
 									  "\tICmp: right operand's lower bound: %f, upper bound: %f\n",
 									  vrRightRangeIt->second.first, vrRightRangeIt->second.second);
-								CmpRes compareResult = compareFCmpWithVariableRange(llvmIrFCmpInstruction,
-														    vrLeftRangeIt->second.first,
-														    vrLeftRangeIt->second.second,
-														    vrRightRangeIt->second.first,
-														    vrRightRangeIt->second.second);
+								bool   neverNaN	     = isKnownNeverNaN(leftOperand, nullptr) &&
+										       isKnownNeverNaN(rightOperand, nullptr);
+								CmpRes compareResult = leftOperand == rightOperand
+											   ? compareFCmpWithItself(llvmIrFCmpInstruction, neverNaN)
+											   : compareFCmpWithVariableRange(llvmIrFCmpInstruction,
+															  vrLeftRangeIt->second.first,
+															  vrLeftRangeIt->second.second,
+															  vrRightRangeIt->second.first,
+															  vrRightRangeIt->second.second,
+															  neverNaN);
 								flexprint(N->Fe, N->Fm, N->Fpinfo, "\tICmp: the comparison result is %d\n",
 									  compareResult);
 								/*
@@ -500,7 +902,9 @@ simplifyControlFlow(State * N, BoundInfo * boundInfo, Function & llvmIrFunction)
 								CmpRes compareResult = compareFCmpWithVariableRange(llvmIrFCmpInstruction,
 															 vrRangeIt->second.first,
 															 vrRangeIt->second.second,
-															 constValue, constValue);
+															 constValue, constValue,
+															 isKnownNeverNaN(leftOperand, nullptr) &&
+															 isKnownNeverNaN(rightOperand, nullptr));
 								flexprint(N->Fe, N->Fm, N->Fpinfo, "\tFCmp: the comparison result is %d\n",
 									  compareResult);
 								/*
@@ -103,7 +103,7 @@ irPassGenLoopsInRightExpression(State *  N, IrNode *  newNodeQTerm, SourceInfo *
 				NULL,
 				genSrcInfo);
 
-	Token *		tokenExpression = (Token *) calloc(1, sizeof(Token));
+	Token *		tokenExpression = (Token *) arenaAllocate(N, sizeof(Token));
 	tokenExpression->type = kNewtonIrNodeType_Tmul;
 	newNodeMulExpression->token = tokenExpression;
 	addLeafWithChainingSeqNoLex(N, newNodeQTerm, newNodeMulExpression, genSrcInfo);
@@ -137,7 +137,7 @@ irPassGenLoopsInRightExpression(State *  N, IrNode *  newNodeQTerm, SourceInfo *
 				NULL,
 				genSrcInfo);
 
-	Token *		tokenExponent = (Token *) calloc(1, sizeof(Token));
+	Token *		tokenExponent = (Token *) arenaAllocate(N, sizeof(Token));
 	tokenExponent->type = kNewtonIrNodeType_Texponentiation;
 	newNodeExponent->token = tokenExponent;
 	
@@ -165,7 +165,7 @@ irPassGenLoopsInRightExpression(State *  N, IrNode *  newNodeQTerm, SourceInfo *
 	newNodeExponentConst->value = 0 - N->invariantList->nullSpaceWithoutDuplicates[kernel]
 									[colIndependent[kernel][whichParameter][whichIndependentParameter]]
 									[rowIndependent[kernel][whichParameter][whichIndependentParameter]];
-	Token *		tokenExponentConst = (Token *) calloc(1, sizeof(Token));
+	Token *		tokenExponentConst = (Token *) arenaAllocate(N, sizeof(Token));
 	tokenExponentConst->type = kNewtonIrNodeType_PnumericConst;
 	newNodeExponentConst->token = tokenExponentConst;
 
@@ -252,7 +252,7 @@ irPassGenExpression(State *  N, IrNode *  node, SourceInfo *  genSrcInfo, int co
 				NULL,
 				NULL,
 				genSrcInfo);
-	Token *		tokenExponent = (Token *) calloc(1, sizeof(Token));
+	Token *		tokenExponent = (Token *) arenaAllocate(N, sizeof(Token));
 	tokenExponent->type = kNewtonIrNodeType_Texponentiation;
 	newNodeExponent->token = tokenExponent;
 
@@ -290,7 +290,7 @@ irPassGenExpression(State *  N, IrNode *  node, SourceInfo *  genSrcInfo, int co
 										[rowIndependent[kernel][whichParameter][0]];
 	}
 
-	Token *		tokenExponentConst = (Token *) calloc(1, sizeof(Token));
+	Token *		tokenExponentConst = (Token *) arenaAllocate(N, sizeof(Token));
 	tokenExponentConst->type = kNewtonIrNodeType_PnumericConst;
 	newNodeExponentConst->token = tokenExponentConst;
 
@@ -377,8 +377,7 @@ irPassDimensionalMatrixConvertToList(State *  N)
 	 *	temporary values, ideally should be more meaningful.
 	 */
 
-	SourceInfo *	genSrcInfo = calloc(1, sizeof(SourceInfo));
-	genSrcInfo->fileName = calloc(strlen("GeneratedByDA") + 1, sizeof(char));
+	SourceInfo *	genSrcInfo = arenaAllocate(N, sizeof(SourceInfo));
 	genSrcInfo->fileName = "GeneratedByDA";
 	genSrcInfo->lineNumber = -1;
 	genSrcInfo->columnNumber = -1;
@@ -617,5 +616,4 @@ irPassDimensionalMatrixConvertToList(State *  N)
 
 		invariant = invariant->next;
 	}
-	free(genSrcInfo);
 }
@@ -102,7 +102,7 @@ newtonLexInit(State *  N, char *  fileName)
 	 */
 	
 	/*
-	 *	The following two are needed in order for getline() to allocate the buffer itself
+	 *	N->lineBuffer points into the source mapped by newtonLex()
 	 */
 	N->lineBuffer = NULL;
 
@@ -124,11 +124,9 @@ newtonLexInit(State *  N, char *  fileName)
 
 	if (N->verbosityLevel & kCommonVerbosityDebugLexer)
 	{
-		Token *	p = N->tokenList;
-		while (p != NULL)
+		for (int i = N->tokenIndex; i < N->tokenCount; i++)
 		{
-			lexDebugPrintToken(N, p, gNewtonTokenDescriptions);
-			p = p->next;
+			lexDebugPrintToken(N, N->tokenBuffer[i], gNewtonTokenDescriptions);
 		}
 	}
 }
@@ -138,17 +136,9 @@ newtonLex(State *  N, char *  fileName)
 {
 	TimeStampTraceMacro(kNewtonTimeStampKey);
 
-	size_t			lineBufferSize;
+	lexMapSource(N, fileName);
 
-	N->filePointer = fopen(fileName, "r");
-	if (N->filePointer == NULL)
-	{
-		flexprint(N->Fe, N->Fm, N->Fperr, "Could not open file \"%s\".\n", fileName);
-		fatal(N, Eopen);
-	}
-
-	lineBufferSize = 0;
-	while ((N->lineLength = getline(&(N->lineBuffer), &lineBufferSize, N->filePointer)) != -1)
+	while (lexNextLine(N))
 	{
 		N->columnNumber = 0;
 		while (N->columnNumber < N->lineLength)
@@ -332,15 +322,9 @@ newtonLex(State *  N, char *  fileName)
 			N->currentToken[N->currentTokenLength++] = N->lineBuffer[N->columnNumber++];
 		}
 		N->lineNumber++;
-
-		/*
-		 *	In order for getline() to allocate the buffer itself on the next iteration...
-		 */
-		N->lineBuffer = NULL;
-		lineBufferSize = 0;
 	}
 
-	fclose(N->filePointer);
+	lexUnmapSource(N);
 
 	return;
 }
@@ -361,12 +345,6 @@ checkComment(State *  N)
 	 *	Gobble any extant chars
 	 */
 	finishToken(N);
-
-	/*
-	 *	NOTE: currentToken is allocated only once, but lineBuffer is allocated each 
-	 *	time a line is read via getline().
-	 */
-	free(N->lineBuffer);
 }
 
 
@@ -426,13 +404,13 @@ checkDoubleQuote(State *  N, bool callFinishTokenFlag)
 	 *	N->lineBuffer must contain the closing quote, else we flag this as a
 	 *	bad string constant (kNewtonIrNodeType_ZbadStringConst)
 	 */
-	if (strchr(&N->lineBuffer[N->columnNumber+1], '"') == NULL)
+	if (memchr(&N->lineBuffer[N->columnNumber+1], '"', N->lineLength - N->columnNumber - 1) == NULL)
 	{
 		newToken = lexAllocateToken(N,		kNewtonIrNodeType_ZbadStringConst	/* type		*/,
 							NULL					/* identifier	*/,
 							0					/* integerConst	*/,
 							0.0					/* realConst	*/,
-							&N->lineBuffer[N->columnNumber]		/* stringConst	*/,
+							arenaStrndup(N, &N->lineBuffer[N->columnNumber], N->lineLength - N->columnNumber)	/* stringConst	*/,
 							NULL					/* sourceInfo	*/);
 	}
 	else
@@ -521,26 +499,22 @@ finishToken(State *  N)
 			bzero(N->currentToken, kCommonMaxBufferLength);
 			N->currentTokenLength = 0;
 
-			char *	newFileName = strdup(N->lastToken->stringConst);
+			char *	newFileName = strdup(N->tokenBuffer[N->tokenCount - 1]->stringConst);
 			if (!newFileName)
 			{
 				fatal(N, Emalloc);
 			}
 
-			Token *	tmp		= N->lastToken;
-			N->lastToken		= N->lastToken->prev;
-			if (N->lastToken == NULL)
-			{
-				N->tokenList = N->lastToken;
-			}
-
-			free(tmp->stringConst);
-			free(tmp);
+			/*
+			 *	Drop the filename token. It lives in the arena, so there is nothing to free.
+			 */
+			N->tokenCount--;
 
 			char *	oldFileName	= N->fileName;
 			int	oldColumnNumber	= N->columnNumber;
 			int	oldLineNumber	= N->lineNumber;
-			FILE *	oldFilePointer	= N->filePointer;
+			SourceBuffer	oldSource	= N->source;
+			char *	oldLineBuffer	= N->lineBuffer;
 
 			N->fileName 		= newFileName;
 			N->columnNumber		= 1;
@@ -551,7 +525,8 @@ finishToken(State *  N)
 			free(newFileName);
 
 			N->fileName		= oldFileName;
-			N->filePointer		= oldFilePointer;
+			N->source		= oldSource;
+			N->lineBuffer		= oldLineBuffer;
 			N->lineNumber		= oldLineNumber;
 
 			/*
@@ -794,12 +769,12 @@ checkGt(State *  N)
 	 */
 	finishToken(N);
 
-	if (N->lineLength >= 2 && N->lineBuffer[N->columnNumber+1] == '<')
+	if (N->lineLength >= 2 && lexLookAhead(N, 1) == '<')
 	{
 		gobble(N, 2);
 		type = kNewtonIrNodeType_Tmutualinf;
 	}
-	if (N->lineLength >= 2 && N->lineBuffer[N->columnNumber+1] == '>')
+	if (N->lineLength >= 2 && lexLookAhead(N, 1) == '>')
 	{
 		gobble(N, 2);
 		type = kNewtonIrNodeType_TrightShift;
@@ -841,12 +816,12 @@ checkLt(State *  N)
 	 */
 	finishToken(N);
 
-	if (N->lineLength >= 3 && N->lineBuffer[N->columnNumber+1] == '-' && N->lineBuffer[N->columnNumber+2] == '>')
+	if (N->lineLength >= 3 && lexLookAhead(N, 1) == '-' && lexLookAhead(N, 2) == '>')
 	{
 		gobble(N, 3);
 		type = kNewtonIrNodeType_Trelated;
 	}
-	else if (N->lineLength >= 2 && N->lineBuffer[N->columnNumber+1] == '<')
+	else if (N->lineLength >= 2 && lexLookAhead(N, 1) == '<')
 	{
 		gobble(N, 2);
 		type = kNewtonIrNodeType_TleftShift;
@@ -887,7 +862,7 @@ checkColon(State *  N)
 	 */
 	finishToken(N);
 
-	if (N->lineLength >= 2 && N->lineBuffer[N->columnNumber+1] == '=')
+	if (N->lineLength >= 2 && lexLookAhead(N, 1) == '=')
 	{
 		gobble(N, 2);
 		type = kNewtonIrNodeType_Tdef;
@@ -923,7 +898,7 @@ checkEqual(State *  N)
 	 */
 	finishToken(N);
 
-	if (N->lineLength >= 2 && N->lineBuffer[N->columnNumber+1] == '=')
+	if (N->lineLength >= 2 && lexLookAhead(N, 1) == '=')
 	{
 		gobble(N, 2);
 		type = kNewtonIrNodeType_Tequals;
@@ -955,7 +930,7 @@ checkProportionality(State * N)
 	IrNodeType		type;
 
 
-	if (N->lineLength >= 2 && N->lineBuffer[N->columnNumber+1] == '<')
+	if (N->lineLength >= 2 && lexLookAhead(N, 1) == '<')
 	{
 		/*
 		 *	Gobble any extant chars.
@@ -993,7 +968,7 @@ checkPlusMinus(State *  N, IrNodeType plusOrMinusTokenType)
 	*	
 	*		If the current character is '-' and the next is '>' create the rightArrow token.
 	*/
-	if (N->lineLength >=2 && N->lineBuffer[N->columnNumber+1] == '>' && N->lineBuffer[N->columnNumber] == '-')
+	if (N->lineLength >=2 && lexLookAhead(N, 1) == '>' && cur(N) == '-')
 	{
 		finishToken(N);
 
@@ -1026,7 +1001,7 @@ checkPlusMinus(State *  N, IrNodeType plusOrMinusTokenType)
 		 */
 		N->currentToken[N->currentTokenLength++] = N->lineBuffer[N->columnNumber++];
 
-		while (isdigit(N->lineBuffer[N->columnNumber]))
+		while (isdigit(cur(N)))
 		{
 			N->currentToken[N->currentTokenLength++] = N->lineBuffer[N->columnNumber++];
 		}
@@ -1040,7 +1015,7 @@ checkPlusMinus(State *  N, IrNodeType plusOrMinusTokenType)
 	 *	If the next character is not a number, then simply do checkSingle.
 	 *	Otherwise, create a positive or negative numeric constant.
 	 */
-	if (N->lineLength >= 2 && (N->lineBuffer[N->columnNumber+1] < '0' || N->lineBuffer[N->columnNumber+1] > '9'))
+	if (N->lineLength >= 2 && (lexLookAhead(N, 1) < '0' || lexLookAhead(N, 1) > '9'))
 	{
 		checkSingle(N, plusOrMinusTokenType);
 
@@ -1078,7 +1053,7 @@ checkMul(State *  N)
 	 */
 	finishToken(N);
 
-	if (N->lineLength >= 2 && N->lineBuffer[N->columnNumber+1] == '*')
+	if (N->lineLength >= 2 && lexLookAhead(N, 1) == '*')
 	{
 		gobble(N, 2);
 		type = kNewtonIrNodeType_Texponentiation;
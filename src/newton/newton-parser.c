@@ -133,7 +133,7 @@ newtonParseFile(State *  N, Scope *  currentScope)
 	/*
 	 *	Skip eof token without using lexGet
 	 */
-	N->tokenList = N->tokenList->next;
+	N->tokenIndex++;
 
 	/*
 	 *	Activate this when Newton's FFI sets have been corrected. See issue #317.
@@ -4871,7 +4871,7 @@ newtonParserErrorRecovery(State *  N, IrNodeType expectedProductionOrToken)
 	}
 
 	/*
-	while (!inFollow(N, expectedProductionOrToken, gNewtonFollows, kNewtonIrNodeTypeMax) && N->tokenList != NULL)
+	while (!inFollow(N, expectedProductionOrToken, gNewtonFollows, kNewtonIrNodeTypeMax) && N->tokenIndex < N->tokenCount)
 	{
 		 *
 		 *	Retrieve token and discard...
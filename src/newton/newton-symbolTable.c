@@ -659,11 +659,7 @@ newtonSymbolTableAllocScope(State *  N)
 
 	Scope *		newScope;
 
-	newScope = (Scope *) calloc(1, sizeof(Scope));
-	if (newScope == NULL)
-	{
-		fatal(N, Emalloc);
-	}
+	newScope = (Scope *) arenaAllocate(N, sizeof(Scope));
 
 	return newScope;
 }
@@ -289,6 +289,11 @@ main(int argc, char *argv[])
 		consolePrintBuffers(N);
 	}
 
+	/*
+	 *	Release the arena backing the tokens, IR and symbol tables in one go.
+	 */
+	dealloc(N);
+
 	return 0;
 }
 
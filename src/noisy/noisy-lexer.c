@@ -98,7 +98,7 @@ noisyLexInit(State *  N, char *  fileName)
 	 */
 	
 	/*
-	 *	The following two are needed in order for getline() to allocate the buffer itself
+	 *	N->lineBuffer points into the source mapped by noisyLex()
 	 */
 	N->lineBuffer = NULL;
 
@@ -123,11 +123,9 @@ noisyLexInit(State *  N, char *  fileName)
 		flexprint(N->Fe, N->Fm, N->Fperr, "Done lexing...\n");
 		
 		flexprint(N->Fe, N->Fm, N->Fperr, "\n\n");
-		Token *	p = N->tokenList;
-		while (p != NULL)
+		for (int i = N->tokenIndex; i < N->tokenCount; i++)
 		{
-			lexDebugPrintToken(N, p, gNoisyTokenDescriptions);
-			p = p->next;
+			lexDebugPrintToken(N, N->tokenBuffer[i], gNoisyTokenDescriptions);
 		}
 		flexprint(N->Fe, N->Fm, N->Fperr, "\n\n");
 	}
@@ -140,15 +138,7 @@ noisyLexInit(State *  N, char *  fileName)
 static void
 noisyLex(State *  N, char *  fileName)
 {
-	size_t		lineBufferSize;
-
-
-	N->filePointer = fopen(fileName, "r");
-	if (N->filePointer == NULL)
-	{
-		flexprint(N->Fe, N->Fm, N->Fperr, "Could not open file \"%s\".\n", fileName);
-		fatal(N, Eopen);
-	}
+	lexMapSource(N, fileName);
 
 
 	/*
@@ -164,13 +154,7 @@ noisyLex(State *  N, char *  fileName)
 	 *		anyway to keep copies of inputs), and feed that file to the compiler.
 	 */
 	
-	/*
-	 *	The following two are needed in order for getline() to allocate the buffer itself
-	 */
-	N->lineBuffer = NULL;
-	lineBufferSize = 0;
-
-	while ((N->lineLength = getline(&(N->lineBuffer), &lineBufferSize, N->filePointer)) != -1)
+	while (lexNextLine(N))
 	{
 		N->columnNumber = 0;
 		while (N->columnNumber < N->lineLength)
@@ -397,15 +381,9 @@ noisyLex(State *  N, char *  fileName)
 			N->currentToken[N->currentTokenLength++] = N->lineBuffer[N->columnNumber++];
 		}
 		N->lineNumber++;
-	
-		/*
-		 *	In order for getline() to allocate the buffer itself on the next iteration...
-		 */
-		N->lineBuffer = NULL;
-		lineBufferSize = 0;
 	}
 
-	fclose(N->filePointer);
+	lexUnmapSource(N);
 	
 }
 
@@ -433,12 +411,6 @@ checkComment(State *  N)
 	 *	Gobble any extant chars
 	 */
 	finishToken(N);
-
-	/*
-	 *	NOTE: currentToken is allocated only once, but lineBuffer is allocated each 
-	 *	time a line is read via getline().
-	 */
-	free(N->lineBuffer);
 }
 
 
@@ -508,7 +480,7 @@ checkWeq3(State *  N, IrNodeType type1, IrNodeType type2, char char2, IrNodeType
 		gobble(N, 2);
 		type = type1;
 	}
-	else if (N->lineLength >= 2 && N->lineBuffer[N->columnNumber+1] == char2)
+	else if (N->lineLength >= 2 && lexLookAhead(N, 1) == char2)
 	{
 		gobble(N, 2);
 		type = type2;
@@ -622,14 +594,14 @@ checkGt(State *  N)
 		type = kNoisyIrNodeType_TgreaterThanEqual;
 	}
 	else if (N->lineLength >= 3 &&
-		N->lineBuffer[N->columnNumber+1] == '>' &&
-		N->lineBuffer[N->columnNumber+2] == '=')
+		lexLookAhead(N, 1) == '>' &&
+		lexLookAhead(N, 2) == '=')
 	{
 		gobble(N, 3);
 		type = kNoisyIrNodeType_TrightShiftAssign;
 	}
 	else if (N->lineLength >= 2 &&
-		N->lineBuffer[N->columnNumber+1] == '>')
+		lexLookAhead(N, 1) == '>')
 	{
 		gobble(N, 2);
 		type = kNoisyIrNodeType_TrightShift;
@@ -672,27 +644,27 @@ checkLt(State *  N)
 		type = kNoisyIrNodeType_TlessThanEqual;
 	}
 	else if (N->lineLength >= 3 &&
-		N->lineBuffer[N->columnNumber+1] == '<' &&
-		N->lineBuffer[N->columnNumber+2] == '=')
+		lexLookAhead(N, 1) == '<' &&
+		lexLookAhead(N, 2) == '=')
 	{
 		gobble(N, 3);
 		type = kNoisyIrNodeType_TleftShiftAssign;
 	}
 	else if (N->lineLength >= 3 &&
-		N->lineBuffer[N->columnNumber+1] == '-' &&
-		N->lineBuffer[N->columnNumber+2] == '=')
+		lexLookAhead(N, 1) == '-' &&
+		lexLookAhead(N, 2) == '=')
 	{
 		gobble(N, 3);
 		type = kNoisyIrNodeType_TchannelOperatorAssign;
 	}
 	else if (N->lineLength >= 2 &&
-		N->lineBuffer[N->columnNumber+1] == '<')
+		lexLookAhead(N, 1) == '<')
 	{
 		gobble(N, 2);
 		type = kNoisyIrNodeType_TleftShift;
 	}
 	else if (N->lineLength >= 2 &&
-		N->lineBuffer[N->columnNumber+1] == '-')
+		lexLookAhead(N, 1) == '-')
 	{
 		gobble(N, 2);
 		type = kNoisyIrNodeType_TchannelOperator;
@@ -735,10 +707,10 @@ checkSingleQuote(State *  N)
 	finishToken(N);
 
 
-	if ((N->lineLength >= 3) && (N->lineBuffer[N->columnNumber+2] == '\''))
+	if ((N->lineLength >= 3) && (lexLookAhead(N, 2) == '\''))
 	{
 		type = kNoisyIrNodeType_TcharConst;
-		quotedChar = N->lineBuffer[N->columnNumber+1];
+		quotedChar = lexLookAhead(N, 1);
 		gobble(N, 3);
 	}
 	else
@@ -751,7 +723,7 @@ checkSingleQuote(State *  N)
 		 *	character after the quote as the token character constant.
 		 */
 		type = kNoisyIrNodeType_ZbadCharConst;
-		quotedChar = N->lineBuffer[N->columnNumber+1];
+		quotedChar = lexLookAhead(N, 1);
 		gobble(N, 1);
 	}
 
@@ -795,13 +767,13 @@ checkDoubleQuote(State *  N, bool callFinishTokenFlag)
 	 *	N->lineBuffer must contain the closing quote, else we flag this as a
 	 *	bad string constant (kNoisyIrNodeType_ZbadStringConst)
 	 */
-	if (strchr(&N->lineBuffer[N->columnNumber+1], '\"') == NULL)
+	if (memchr(&N->lineBuffer[N->columnNumber+1], '\"', N->lineLength - N->columnNumber - 1) == NULL)
 	{
 		newToken = lexAllocateToken(N,	kNoisyIrNodeType_ZbadStringConst	/* type		*/,
 							NULL					/* identifier	*/,
 							0					/* integerConst	*/,
 							0.0					/* realConst	*/,
-							&N->lineBuffer[N->columnNumber]		/* stringConst	*/,
+							arenaStrndup(N, &N->lineBuffer[N->columnNumber], N->lineLength - N->columnNumber)	/* stringConst	*/,
 							NULL					/* sourceInfo	*/);
 	}
 	else
@@ -885,12 +857,12 @@ checkMinus(State *  N)
 		gobble(N, 2);
 		type = kNoisyIrNodeType_TminusAssign;
 	}
-	else if (N->lineLength >= 2 && N->lineBuffer[N->columnNumber+1] == '-')
+	else if (N->lineLength >= 2 && lexLookAhead(N, 1) == '-')
 	{
 		gobble(N, 2);
 		type = kNoisyIrNodeType_TminusMinus;
 	}
-	else if (N->lineLength >= 2 && N->lineBuffer[N->columnNumber+1] == '>')
+	else if (N->lineLength >= 2 && lexLookAhead(N, 1) == '>')
 	{
 		gobble(N, 2);
 		type = kNoisyIrNodeType_Tarrow;
@@ -1194,26 +1166,22 @@ finishToken(State *  N)
 			bzero(N->currentToken, kCommonMaxBufferLength);
 			N->currentTokenLength = 0;
 
-			char *	newFileName = strdup(N->lastToken->stringConst);
+			char *	newFileName = strdup(N->tokenBuffer[N->tokenCount - 1]->stringConst);
 			if (!newFileName)
 			{
 				fatal(N, Emalloc);
 			}
 
-			Token *	tmp		= N->lastToken;
-			N->lastToken		= N->lastToken->prev;
-			if (N->lastToken == NULL)
-			{
-				N->tokenList = N->lastToken;
-			}
-
-			free(tmp->stringConst);
-			free(tmp);
+			/*
+			 *	Drop the filename token. It lives in the arena, so there is nothing to free.
+			 */
+			N->tokenCount--;
 
 			char *	oldFileName	= N->fileName;
 			int	oldColumnNumber	= N->columnNumber;
 			int	oldLineNumber	= N->lineNumber;
-			FILE *	oldFilePointer	= N->filePointer;
+			SourceBuffer	oldSource	= N->source;
+			char *	oldLineBuffer	= N->lineBuffer;
 
 			N->fileName 		= newFileName;
 			N->columnNumber		= 1;
@@ -1224,7 +1192,8 @@ finishToken(State *  N)
 			free(newFileName);
 
 			N->fileName		= oldFileName;
-			N->filePointer		= oldFilePointer;
+			N->source		= oldSource;
+			N->lineBuffer		= oldLineBuffer;
 			N->lineNumber		= oldLineNumber;
 
 			/*
@@ -3156,7 +3156,7 @@ noisyParseFunctionDefn(State *  N, Scope *  scope)
 	 *	main AST with new links, so we make copies.
 	 */
 	
-	IrNode * typeTree = calloc(1,sizeof(IrNode));
+	IrNode * typeTree = arenaAllocate(N, sizeof(IrNode));
 	addLeaf(N, typeTree, shallowCopyIrNode(N, t1));
 	addLeaf(N, typeTree, shallowCopyIrNode(N, t2));
 
@@ -8046,7 +8046,7 @@ noisyParserErrorRecovery(State *  N, IrNodeType expectedProductionOrToken)
 	}
 
 	/*
-	while (!inFollow(N, expectedProductionOrToken, gNoisyFollows, kNoisyIrNodeTypeMax) && N->tokenList != NULL)
+	while (!inFollow(N, expectedProductionOrToken, gNoisyFollows, kNoisyIrNodeTypeMax) && N->tokenIndex < N->tokenCount)
 	{
 		 *
 		 *	Retrieve token and discard...
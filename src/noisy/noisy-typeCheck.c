@@ -1473,19 +1473,22 @@ getNoisyTypeFromExpression(State * N, IrNode * noisyExpressionNode, Scope * curr
                                 */
                                 funcSymbol->isTypeComplete = true;
 
-                                Token * t = calloc(1,sizeof(Token));
+                                Token * t = arenaAllocate(N, sizeof(Token));
                                 t->sourceInfo = funcSymbol->sourceInfo;
 
 				// FIX: NoisySymbolType to IrNodeType without a cast
                                 t->type = kNoisySymbolTypeNamegenDefinition;
-                                asprintf(&t->identifier,"%s_%d",funcSymbol->identifier,loadCount);
+                                char * newFunctionName;
+                                asprintf(&newFunctionName,"%s_%d",funcSymbol->identifier,loadCount);
+                                t->identifier = arenaStrdup(N, newFunctionName);
+                                free(newFunctionName);
 
                                 Symbol * newFunctionSym = commonSymbolTableAddOrLookupSymbolForToken(N,N->noisyIrTopScope->firstChild,t);
                                 newFunctionSym->functionDefinition = deepCopyIrNode(N,funcSymbol->functionDefinition,loadCount);
                                 noisyFunctionDefnTypeCheck(N,newFunctionSym->functionDefinition,N->noisyIrTopScope->firstChild);
                                 newFunctionSym->parameterNum = funcSymbol->parameterNum;
                                 newFunctionSym->isTypeComplete = funcSymbol->isTypeComplete;
-                                IrNode * newTypeTree = calloc(1,sizeof(IrNode));
+                                IrNode * newTypeTree = arenaAllocate(N, sizeof(IrNode));
                                 newTypeTree->irLeftChild = RL(newFunctionSym->functionDefinition);
                                 newTypeTree->irRightChild = RRL(newFunctionSym->functionDefinition);
                                 newFunctionSym->typeTree = newTypeTree;